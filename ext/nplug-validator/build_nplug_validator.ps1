@@ -14,7 +14,8 @@
 #   osx-x64
 #   osx-arm64
 # -------------------------------------------------------------
-$cmake_relative_build_folder = "vst3sdk-prefix/src/vst3sdk-build"
+$cmake_sdk_build_folder = "vst3sdk-prefix/src/vst3sdk-build"
+$cmake_relative_build_folder = $cmake_sdk_build_folder
 if ($IsWindows) {
     $cmake_relative_build_folder = "$cmake_relative_build_folder/bin"
 }
@@ -22,4 +23,23 @@ else {
     $cmake_relative_build_folder = "$cmake_relative_build_folder/lib"
 }
 
-& "$PSScriptRoot/../CMake-Build-Platforms.ps1" -bit32 $false -CMakeConfig Release -CMakeRelativeBuildFolder $cmake_relative_build_folder
\ No newline at end of file
+& "$PSScriptRoot/../CMake-Build-Platforms.ps1" -bit32 $false -CMakeConfig Release -CMakeRelativeBuildFolder $cmake_relative_build_folder
+if ($LastExitCode -ne 0) {
+    exit $LastExitCode
+}
+
+# The benchmark host and its reference plugin are not shared libraries, so they are collected separately
+# in build/package/<rid>/benchmark, next to the native folder packaged with NPlug.Validator
+$ErrorActionPreference = "Stop"
+$benchmark_executable = "nplug_benchmark"
+if ($IsWindows) {
+    $benchmark_executable = "$benchmark_executable.exe"
+}
+foreach ($rid_folder in Get-ChildItem -Path "build/package" -Directory) {
+    $rid = $rid_folder.Name
+    $sdk_build_folder = "build/$rid/$cmake_sdk_build_folder"
+    $benchmark_folder = "build/package/$rid/benchmark/"
+    New-Item -type Directory -Path $benchmark_folder -Force
+    Copy-Item "$sdk_build_folder/bin/Release/$benchmark_executable" -Destination $benchmark_folder
+    Copy-Item "$sdk_build_folder/VST3/Release/nplug_benchmark_reference.vst3" -Destination $benchmark_folder -Recurse -Force
+}
\ No newline at end of file
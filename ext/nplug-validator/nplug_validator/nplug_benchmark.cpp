@@ -0,0 +1,568 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+// nplug_benchmark: a minimal native VST3 host measuring the latency of a block as seen by a host.
+//
+// It loads a .vst3 module, runs setupProcessing/process for N blocks over a matrix of
+// block sizes, sample rates, channel counts and sample sizes, and reports the per-block
+// latency (p50/p99/p99.9/max + a log2 histogram) as JSON.
+// An optional baseline plugin (e.g nplug_benchmark_reference.vst3) can be passed to
+// quantify the overhead of the proxy and the managed processing.
+
+#include "public.sdk/source/vst/hosting/hostclasses.h"
+#include "public.sdk/source/vst/hosting/module.h"
+#include "public.sdk/source/vst/hosting/plugprovider.h"
+#include "public.sdk/source/vst/hosting/processdata.h"
+#include "pluginterfaces/vst/ivstaudioprocessor.h"
+#include "pluginterfaces/vst/ivstcomponent.h"
+#include "pluginterfaces/vst/vstspeaker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+namespace {
+
+//------------------------------------------------------------------------
+struct BenchmarkOptions
+{
+    std::string pluginPath;
+    std::string baselinePath;
+    std::string outputPath;
+    int32 blockCount = 10000;
+    int32 warmupCount = 500;
+    std::vector<int32> blockSizes = {32, 64, 128, 256, 512, 1024};
+    std::vector<double> sampleRates = {44100.0, 48000.0, 96000.0};
+    std::vector<int32> channelCounts = {1, 2};
+    std::vector<int32> sampleSizes = {kSample32, kSample64};
+};
+
+//------------------------------------------------------------------------
+struct BenchmarkConfig
+{
+    int32 blockSize;
+    double sampleRate;
+    int32 channelCount;
+    int32 sampleSize;
+};
+
+//------------------------------------------------------------------------
+struct BenchmarkResult
+{
+    BenchmarkConfig config;
+    bool supported = false;
+    // The plugin failed while processing, the results of the plugin are not valid
+    bool failed = false;
+    std::string error;
+    int64_t p50 = 0;
+    int64_t p99 = 0;
+    int64_t p999 = 0;
+    int64_t max = 0;
+    double mean = 0.0;
+    // Bucket i counts the blocks with a latency in [2^i, 2^(i+1)) nanoseconds
+    std::vector<int64_t> histogram;
+};
+
+//------------------------------------------------------------------------
+template <typename T>
+bool parseList (const char* text, std::vector<T>& values)
+{
+    values.clear ();
+    std::stringstream stream (text);
+    std::string item;
+    while (std::getline (stream, item, ','))
+    {
+        std::stringstream itemStream (item);
+        T value {};
+        if (!(itemStream >> value) || value <= 0)
+            return false;
+        values.push_back (value);
+    }
+    return !values.empty ();
+}
+
+//------------------------------------------------------------------------
+void printUsage ()
+{
+    std::cerr << "Usage: nplug_benchmark <plugin.vst3> [options]" << std::endl
+              << "  --baseline <plugin.vst3>  Native plugin used as a baseline to compute the overhead" << std::endl
+              << "  --blocks <count>          Number of measured blocks per configuration (default 10000)" << std::endl
+              << "  --warmup <count>          Number of warmup blocks per configuration (default 500)" << std::endl
+              << "  --block-sizes <list>      Comma separated block sizes (default 32,64,128,256,512,1024)" << std::endl
+              << "  --sample-rates <list>     Comma separated sample rates (default 44100,48000,96000)" << std::endl
+              << "  --channels <list>         Comma separated channel counts (default 1,2)" << std::endl
+              << "  --sample-sizes <list>     Comma separated sample sizes in bits, 32 and/or 64 (default 32,64)" << std::endl
+              << "  --output <file.json>      Output file (default stdout)" << std::endl;
+}
+
+//------------------------------------------------------------------------
+bool parseArguments (int argc, char* argv[], BenchmarkOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--baseline" && hasValue)
+            options.baselinePath = argv[++i];
+        else if (arg == "--output" && hasValue)
+            options.outputPath = argv[++i];
+        else if (arg == "--blocks" && hasValue)
+            options.blockCount = std::atoi (argv[++i]);
+        else if (arg == "--warmup" && hasValue)
+            options.warmupCount = std::atoi (argv[++i]);
+        else if (arg == "--block-sizes" && hasValue)
+        {
+            if (!parseList (argv[++i], options.blockSizes))
+                return false;
+        }
+        else if (arg == "--sample-rates" && hasValue)
+        {
+            if (!parseList (argv[++i], options.sampleRates))
+                return false;
+        }
+        else if (arg == "--channels" && hasValue)
+        {
+            if (!parseList (argv[++i], options.channelCounts))
+                return false;
+        }
+        else if (arg == "--sample-sizes" && hasValue)
+        {
+            std::vector<int32> bits;
+            if (!parseList (argv[++i], bits))
+                return false;
+            options.sampleSizes.clear ();
+            for (auto bit : bits)
+            {
+                if (bit == 32)
+                    options.sampleSizes.push_back (kSample32);
+                else if (bit == 64)
+                    options.sampleSizes.push_back (kSample64);
+                else
+                    return false;
+            }
+        }
+        else if (!arg.empty () && arg[0] != '-' && options.pluginPath.empty ())
+            options.pluginPath = arg;
+        else
+            return false;
+    }
+    return !options.pluginPath.empty () && options.blockCount > 0 && options.warmupCount >= 0;
+}
+
+//------------------------------------------------------------------------
+SpeakerArrangement getSpeakerArrangement (int32 channelCount)
+{
+    switch (channelCount)
+    {
+        case 1: return SpeakerArr::kMono;
+        case 2: return SpeakerArr::kStereo;
+        default: return channelCount >= 64 ? ~SpeakerArrangement (0) : (SpeakerArrangement (1) << channelCount) - 1;
+    }
+}
+
+//------------------------------------------------------------------------
+int64_t getPercentile (const std::vector<int64_t>& sorted, double percentile)
+{
+    auto index = static_cast<size_t> (std::ceil (percentile * static_cast<double> (sorted.size ())));
+    index = index == 0 ? 0 : index - 1;
+    return sorted[std::min (index, sorted.size () - 1)];
+}
+
+//------------------------------------------------------------------------
+template <typename Sample>
+void fillInputs (HostProcessData& data, int32 blockSize, uint32_t& seed)
+{
+    for (int32 bus = 0; bus < data.numInputs; bus++)
+    {
+        auto& buffers = data.inputs[bus];
+        for (int32 channel = 0; channel < buffers.numChannels; channel++)
+        {
+            Sample* samples;
+            if constexpr (std::is_same_v<Sample, Sample64>)
+                samples = buffers.channelBuffers64[channel];
+            else
+                samples = buffers.channelBuffers32[channel];
+            for (int32 i = 0; i < blockSize; i++)
+            {
+                // Cheap LCG noise, we only need non-silent input
+                seed = seed * 1664525u + 1013904223u;
+                samples[i] = static_cast<Sample> ((seed >> 8) * (1.0 / 16777216.0) - 0.5);
+            }
+        }
+        buffers.silenceFlags = 0;
+    }
+}
+
+//------------------------------------------------------------------------
+class BenchmarkHost
+{
+public:
+    BenchmarkHost (const BenchmarkOptions& options) : options (options) {}
+
+    bool load (const std::string& path, std::string& error)
+    {
+        module = VST3::Hosting::Module::create (path, error);
+        if (!module)
+            return false;
+
+        auto factory = module->getFactory ();
+        for (auto& classInfo : factory.classInfos ())
+        {
+            if (classInfo.category () == kVstAudioEffectClass)
+            {
+                plugProvider = owned (new PlugProvider (factory, classInfo, true));
+                if (!plugProvider->initialize ())
+                {
+                    error = "Unable to initialize the plugin " + classInfo.name ();
+                    plugProvider = nullptr;
+                    return false;
+                }
+                component = owned (plugProvider->getComponent ());
+                processor = FUnknownPtr<IAudioProcessor> (component);
+                if (!processor)
+                {
+                    error = "The component " + classInfo.name () + " does not implement IAudioProcessor";
+                    return false;
+                }
+                name = classInfo.name ();
+                return true;
+            }
+        }
+
+        error = "No audio effect class found in " + path;
+        return false;
+    }
+
+    const std::string& getName () const { return name; }
+
+    BenchmarkResult run (const BenchmarkConfig& config)
+    {
+        BenchmarkResult result;
+        result.config = config;
+
+        if (config.sampleSize == kSample64 && processor->canProcessSampleSize (kSample64) != kResultTrue)
+        {
+            result.error = "Float64 not supported";
+            return result;
+        }
+
+        if (!setupBuses (config.channelCount))
+        {
+            result.error = "Bus arrangement not supported";
+            return result;
+        }
+
+        ProcessSetup setup {kRealtime, config.sampleSize, config.blockSize, config.sampleRate};
+        if (processor->setupProcessing (setup) != kResultOk)
+        {
+            result.error = "setupProcessing failed";
+            return result;
+        }
+
+        HostProcessData data;
+        if (!data.prepare (*component, config.blockSize, config.sampleSize))
+        {
+            result.error = "Unable to allocate the process buffers";
+            return result;
+        }
+
+        ProcessContext processContext {};
+        processContext.state = ProcessContext::kPlaying | ProcessContext::kTempoValid;
+        processContext.sampleRate = config.sampleRate;
+        processContext.tempo = 120.0;
+
+        data.processMode = kRealtime;
+        data.symbolicSampleSize = config.sampleSize;
+        data.numSamples = config.blockSize;
+        data.processContext = &processContext;
+
+        component->setActive (true);
+        processor->setProcessing (true);
+
+        std::vector<int64_t> timings;
+        timings.reserve (options.blockCount);
+
+        uint32_t seed = 0x12345678u;
+        int32 totalBlocks = options.warmupCount + options.blockCount;
+        for (int32 block = 0; block < totalBlocks; block++)
+        {
+            if (config.sampleSize == kSample64)
+                fillInputs<Sample64> (data, config.blockSize, seed);
+            else
+                fillInputs<Sample32> (data, config.blockSize, seed);
+
+            auto start = std::chrono::steady_clock::now ();
+            auto processResult = processor->process (data);
+            auto end = std::chrono::steady_clock::now ();
+
+            if (processResult != kResultOk)
+            {
+                processor->setProcessing (false);
+                component->setActive (false);
+                data.unprepare ();
+                result.failed = true;
+                result.error = "process() failed at block " + std::to_string (block) + " with result " + std::to_string (processResult);
+                return result;
+            }
+
+            processContext.projectTimeSamples += config.blockSize;
+            if (block >= options.warmupCount)
+                timings.push_back (std::chrono::duration_cast<std::chrono::nanoseconds> (end - start).count ());
+        }
+
+        processor->setProcessing (false);
+        component->setActive (false);
+        data.unprepare ();
+
+        computeStatistics (timings, result);
+        result.supported = true;
+        return result;
+    }
+
+    void unload ()
+    {
+        processor = nullptr;
+        component = nullptr;
+        plugProvider = nullptr;
+        module = nullptr;
+    }
+
+private:
+    bool setupBuses (int32 channelCount)
+    {
+        auto inputBusCount = component->getBusCount (kAudio, kInput);
+        auto outputBusCount = component->getBusCount (kAudio, kOutput);
+        std::vector<SpeakerArrangement> inputs (inputBusCount, getSpeakerArrangement (channelCount));
+        std::vector<SpeakerArrangement> outputs (outputBusCount, getSpeakerArrangement (channelCount));
+        if (processor->setBusArrangements (inputs.data (), inputBusCount, outputs.data (), outputBusCount) != kResultTrue)
+        {
+            // The plugin might only support its default arrangement, accept it if it matches
+            for (int32 i = 0; i < inputBusCount; i++)
+            {
+                BusInfo busInfo {};
+                if (component->getBusInfo (kAudio, kInput, i, busInfo) != kResultOk || busInfo.channelCount != channelCount)
+                    return false;
+            }
+            for (int32 i = 0; i < outputBusCount; i++)
+            {
+                BusInfo busInfo {};
+                if (component->getBusInfo (kAudio, kOutput, i, busInfo) != kResultOk || busInfo.channelCount != channelCount)
+                    return false;
+            }
+        }
+
+        for (int32 i = 0; i < inputBusCount; i++)
+            component->activateBus (kAudio, kInput, i, true);
+        for (int32 i = 0; i < outputBusCount; i++)
+            component->activateBus (kAudio, kOutput, i, true);
+        return true;
+    }
+
+    static void computeStatistics (std::vector<int64_t>& timings, BenchmarkResult& result)
+    {
+        double sum = 0.0;
+        for (auto timing : timings)
+        {
+            sum += static_cast<double> (timing);
+            size_t bucket = 0;
+            while (bucket < 63 && (int64_t (1) << (bucket + 1)) <= timing)
+                bucket++;
+            if (result.histogram.size () <= bucket)
+                result.histogram.resize (bucket + 1, 0);
+            result.histogram[bucket]++;
+        }
+
+        std::sort (timings.begin (), timings.end ());
+        result.mean = sum / static_cast<double> (timings.size ());
+        result.p50 = getPercentile (timings, 0.50);
+        result.p99 = getPercentile (timings, 0.99);
+        result.p999 = getPercentile (timings, 0.999);
+        result.max = timings.back ();
+    }
+
+    const BenchmarkOptions& options;
+    VST3::Hosting::Module::Ptr module;
+    IPtr<PlugProvider> plugProvider;
+    IPtr<IComponent> component;
+    IPtr<IAudioProcessor> processor;
+    std::string name;
+};
+
+//------------------------------------------------------------------------
+std::vector<BenchmarkResult> runMatrix (BenchmarkHost& host, const BenchmarkOptions& options)
+{
+    std::vector<BenchmarkResult> results;
+    for (auto sampleSize : options.sampleSizes)
+        for (auto sampleRate : options.sampleRates)
+            for (auto channelCount : options.channelCounts)
+                for (auto blockSize : options.blockSizes)
+                {
+                    BenchmarkConfig config {blockSize, sampleRate, channelCount, sampleSize};
+                    std::cerr << host.getName () << ": " << (sampleSize == kSample64 ? "Float64" : "Float32") << " "
+                              << sampleRate << "Hz " << channelCount << "ch " << blockSize << " samples" << std::endl;
+                    results.push_back (host.run (config));
+                    if (results.back ().failed)
+                    {
+                        std::cerr << host.getName () << ": " << results.back ().error << std::endl;
+                        return results;
+                    }
+                }
+    return results;
+}
+
+//------------------------------------------------------------------------
+std::string escapeJson (const std::string& text)
+{
+    std::string result;
+    for (auto c : text)
+    {
+        switch (c)
+        {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default: result += c; break;
+        }
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------
+void writeResult (std::ostream& out, const BenchmarkResult& result, const BenchmarkResult* baseline)
+{
+    auto& config = result.config;
+    out << "    {\"blockSize\": " << config.blockSize
+        << ", \"sampleRate\": " << config.sampleRate
+        << ", \"channels\": " << config.channelCount
+        << ", \"sampleSize\": \"" << (config.sampleSize == kSample64 ? "Float64" : "Float32") << "\"";
+
+    if (!result.supported)
+    {
+        out << ", \"supported\": false" << (result.failed ? ", \"failed\": true" : "") << ", \"error\": \"" << escapeJson (result.error) << "\"}";
+        return;
+    }
+
+    // Time budget of a block in realtime, useful to compare against the measured latencies
+    auto budgetNs = static_cast<double> (config.blockSize) * 1e9 / config.sampleRate;
+    out << ", \"supported\": true"
+        << ", \"budgetNs\": " << static_cast<int64_t> (budgetNs)
+        << ", \"meanNs\": " << static_cast<int64_t> (result.mean)
+        << ", \"p50Ns\": " << result.p50
+        << ", \"p99Ns\": " << result.p99
+        << ", \"p999Ns\": " << result.p999
+        << ", \"maxNs\": " << result.max
+        << ", \"histogramLog2Ns\": [";
+    for (size_t i = 0; i < result.histogram.size (); i++)
+        out << (i > 0 ? ", " : "") << result.histogram[i];
+    out << "]";
+
+    if (baseline && baseline->supported)
+    {
+        out << ", \"overhead\": {\"p50Ns\": " << (result.p50 - baseline->p50)
+            << ", \"p99Ns\": " << (result.p99 - baseline->p99)
+            << ", \"p999Ns\": " << (result.p999 - baseline->p999)
+            << ", \"maxNs\": " << (result.max - baseline->max)
+            << ", \"p50Ratio\": " << (baseline->p50 > 0 ? static_cast<double> (result.p50) / static_cast<double> (baseline->p50) : 0.0)
+            << "}";
+    }
+    out << "}";
+}
+
+//------------------------------------------------------------------------
+void writeResults (std::ostream& out, const std::string& name, const std::vector<BenchmarkResult>& results, const std::vector<BenchmarkResult>* baselines)
+{
+    out << "  {\"plugin\": \"" << escapeJson (name) << "\", \"results\": [" << std::endl;
+    for (size_t i = 0; i < results.size (); i++)
+    {
+        // The baseline has less results if it failed
+        writeResult (out, results[i], baselines && i < baselines->size () ? &(*baselines)[i] : nullptr);
+        out << (i + 1 < results.size () ? "," : "") << std::endl;
+    }
+    out << "  ]}";
+}
+
+//------------------------------------------------------------------------
+bool runPlugin (const std::string& path, const BenchmarkOptions& options, std::string& name, std::vector<BenchmarkResult>& results)
+{
+    BenchmarkHost host (options);
+    std::string error;
+    if (!host.load (path, error))
+    {
+        std::cerr << "Error loading " << path << ": " << error << std::endl;
+        return false;
+    }
+    name = host.getName ();
+    results = runMatrix (host, options);
+    host.unload ();
+    return true;
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    BenchmarkOptions options;
+    if (!parseArguments (argc, argv, options))
+    {
+        printUsage ();
+        return 1;
+    }
+
+    HostApplication hostApplication;
+    PluginContextFactory::instance ().setPluginContext (&hostApplication);
+
+    std::string pluginName;
+    std::vector<BenchmarkResult> pluginResults;
+    if (!runPlugin (options.pluginPath, options, pluginName, pluginResults))
+        return 1;
+
+    std::string baselineName;
+    std::vector<BenchmarkResult> baselineResults;
+    bool hasBaseline = !options.baselinePath.empty ();
+    if (hasBaseline && !runPlugin (options.baselinePath, options, baselineName, baselineResults))
+        return 1;
+
+    std::ofstream file;
+    if (!options.outputPath.empty ())
+    {
+        file.open (options.outputPath);
+        if (!file)
+        {
+            std::cerr << "Unable to open output file " << options.outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = file.is_open () ? file : std::cout;
+
+    out << "{\"blocks\": " << options.blockCount << ", \"warmup\": " << options.warmupCount << ", \"plugins\": [" << std::endl;
+    writeResults (out, pluginName, pluginResults, hasBaseline ? &baselineResults : nullptr);
+    if (hasBaseline)
+    {
+        out << "," << std::endl;
+        writeResults (out, baselineName, baselineResults, nullptr);
+    }
+    out << std::endl << "]}" << std::endl;
+
+    PluginContextFactory::instance ().setPluginContext (nullptr);
+
+    // A plugin failing to process is an error, its partial results are only written for diagnostics
+    auto hasFailed = [] (const std::vector<BenchmarkResult>& results) {
+        return std::any_of (results.begin (), results.end (), [] (const BenchmarkResult& result) { return result.failed; });
+    };
+    return hasFailed (pluginResults) || hasFailed (baselineResults) ? 1 : 0;
+}
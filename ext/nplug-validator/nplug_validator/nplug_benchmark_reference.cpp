@@ -0,0 +1,107 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+// nplug_benchmark_reference: a trivial native pass-through plugin used as a baseline by nplug_benchmark
+// to quantify the overhead of the nplug_proxy trampoline and the managed processing.
+
+#include "public.sdk/source/main/pluginfactory.h"
+#include "public.sdk/source/vst/vstaudioeffect.h"
+#include "public.sdk/source/vst/vsteditcontroller.h"
+#include "pluginterfaces/vst/ivstaudioprocessor.h"
+#include "pluginterfaces/vst/vstspeaker.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+static const FUID kReferenceProcessorUID (0x6E506C75, 0x67426E63, 0x68526566, 0x50726F63);
+static const FUID kReferenceControllerUID (0x6E506C75, 0x67426E63, 0x68526566, 0x43747272);
+
+//------------------------------------------------------------------------
+class ReferenceProcessor : public AudioEffect
+{
+public:
+    ReferenceProcessor () { setControllerClass (kReferenceControllerUID); }
+
+    static FUnknown* createInstance (void*) { return static_cast<IAudioProcessor*> (new ReferenceProcessor); }
+
+    tresult PLUGIN_API initialize (FUnknown* context) override
+    {
+        auto result = AudioEffect::initialize (context);
+        if (result != kResultOk)
+            return result;
+
+        addAudioInput (STR16 ("Input"), SpeakerArr::kStereo);
+        addAudioOutput (STR16 ("Output"), SpeakerArr::kStereo);
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API setBusArrangements (SpeakerArrangement* inputs, int32 numIns, SpeakerArrangement* outputs, int32 numOuts) override
+    {
+        // Accept any arrangement as long as input and output are symmetric
+        if (numIns == 1 && numOuts == 1 && inputs[0] == outputs[0])
+            return AudioEffect::setBusArrangements (inputs, numIns, outputs, numOuts);
+        return kResultFalse;
+    }
+
+    tresult PLUGIN_API canProcessSampleSize (int32 symbolicSampleSize) override
+    {
+        return symbolicSampleSize == kSample32 || symbolicSampleSize == kSample64 ? kResultTrue : kResultFalse;
+    }
+
+    tresult PLUGIN_API process (ProcessData& data) override
+    {
+        if (data.numSamples <= 0 || data.numInputs == 0 || data.numOutputs == 0)
+            return kResultOk;
+
+        auto& input = data.inputs[0];
+        auto& output = data.outputs[0];
+        auto channelCount = std::min (input.numChannels, output.numChannels);
+        bool is64 = data.symbolicSampleSize == kSample64;
+        auto byteCount = static_cast<size_t> (data.numSamples) * (is64 ? sizeof (Sample64) : sizeof (Sample32));
+        for (int32 channel = 0; channel < channelCount; channel++)
+        {
+            void* source = is64 ? static_cast<void*> (input.channelBuffers64[channel]) : static_cast<void*> (input.channelBuffers32[channel]);
+            void* destination = is64 ? static_cast<void*> (output.channelBuffers64[channel]) : static_cast<void*> (output.channelBuffers32[channel]);
+            if (source != destination)
+                std::memcpy (destination, source, byteCount);
+        }
+        output.silenceFlags = input.silenceFlags;
+        return kResultOk;
+    }
+};
+
+//------------------------------------------------------------------------
+class ReferenceController : public EditController
+{
+public:
+    static FUnknown* createInstance (void*) { return static_cast<IEditController*> (new ReferenceController); }
+};
+
+//------------------------------------------------------------------------
+BEGIN_FACTORY_DEF ("NPlug", "https://github.com/xoofx/NPlug", "")
+
+    DEF_CLASS2 (INLINE_UID_FROM_FUID (kReferenceProcessorUID),
+                PClassInfo::kManyInstances,
+                kVstAudioEffectClass,
+                "NPlug Benchmark Reference",
+                Vst::kDistributable,
+                Vst::PlugType::kFx,
+                "1.0.0",
+                kVstVersionString,
+                ReferenceProcessor::createInstance)
+
+    DEF_CLASS2 (INLINE_UID_FROM_FUID (kReferenceControllerUID),
+                PClassInfo::kManyInstances,
+                kVstComponentControllerClass,
+                "NPlug Benchmark Reference Controller",
+                0,
+                "",
+                "1.0.0",
+                kVstVersionString,
+                ReferenceController::createInstance)
+
+END_FACTORY
@@ -24,3 +24,43 @@ if(APPLE AND NOT XCODE)
             ${COCOA_FRAMEWORK}
     )
 endif(APPLE AND NOT XCODE)
+
+# Native benchmark host measuring the per-block latency of a plugin as seen by a host
+set(benchmark_target nplug_benchmark)
+
+add_executable(${benchmark_target} source/nplug_benchmark.cpp)
+if(SDK_IDE_HOSTING_EXAMPLES_FOLDER)
+    set_target_properties(${benchmark_target}
+        PROPERTIES
+            ${SDK_IDE_HOSTING_EXAMPLES_FOLDER}
+    )
+endif(SDK_IDE_HOSTING_EXAMPLES_FOLDER)
+target_compile_features(${benchmark_target}
+    PUBLIC
+        cxx_std_17
+)
+target_link_libraries(${benchmark_target}
+    PRIVATE
+        sdk_hosting
+)
+smtg_target_codesign(${benchmark_target})
+smtg_target_setup_universal_binary(${benchmark_target})
+if(APPLE AND NOT XCODE)
+    target_link_libraries(${benchmark_target}
+        PRIVATE
+            ${COCOA_FRAMEWORK}
+    )
+endif(APPLE AND NOT XCODE)
+
+# Trivial native pass-through plugin used as a baseline by nplug_benchmark
+set(benchmark_reference_target nplug_benchmark_reference)
+
+smtg_add_vst3plugin(${benchmark_reference_target} source/nplug_benchmark_reference.cpp)
+target_compile_features(${benchmark_reference_target}
+    PUBLIC
+        cxx_std_17
+)
+target_link_libraries(${benchmark_reference_target}
+    PRIVATE
+        sdk
+)
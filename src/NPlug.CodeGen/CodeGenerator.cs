@@ -42,7 +42,6 @@ public class CodeGenerator
     private readonly HashSet<string> _pluginOnly;
     private readonly HashSet<string> _typesToExclude;
     private readonly List<CSharpGeneratedFile> _toManagedFiles;
-    private readonly List<CSharpStruct> _allGeneratedVtbls;
     private CSharpClass? _container;
 
 
@@ -80,7 +79,6 @@ public class CodeGenerator
         _fileToContent = new Dictionary<string, string[]>();
         _cppTypeToCSharpType = new Dictionary<string, CSharpType>();
         _toManagedFiles = new List<CSharpGeneratedFile>();
-        _allGeneratedVtbls = new List<CSharpStruct>();
         _sdkFolder = sdkFolder;
         _pluginInterfacesFolder = Path.Combine(_sdkFolder, "pluginterfaces");
         _destinationFolder = string.Empty;
@@ -226,33 +224,9 @@ public class CodeGenerator
             }
         }
 
-        GenerateComObjectManager();
         GenerateGuidToName();
     }
 
-    private void GenerateComObjectManager()
-    {
-        // public sealed unsafe partial class ComObjectManager : IDisposable
-        var comObjectManager = new CSharpClass("ComObjectManager");
-        comObjectManager.Modifiers = CSharpModifiers.Partial;
-        comObjectManager.Visibility = CSharpVisibility.Public;
-        var staticMethod = new CSharpMethod("RegisterAllInterfaces")
-        {
-            ReturnType = CSharpPrimitiveType.Void(),
-            Modifiers = CSharpModifiers.Static,
-            Visibility = CSharpVisibility.Private,
-        };
-        comObjectManager.Members.Add(staticMethod);
-        staticMethod.Body = (writer, element) =>
-        {
-            foreach (var item in _allGeneratedVtbls)
-            {
-                writer.WriteLine($"Register<{item.Name}>();");
-            }
-        };
-        _container!.Members.Add(comObjectManager);
-    }
-
     private void GenerateGuidToName()
     {
         // public sealed unsafe partial class ComObjectManager : IDisposable
@@ -821,7 +795,6 @@ public class CodeGenerator
                         initializeVtbl.ReturnType = CSharpPrimitiveType.Void();
                         initializeVtbl.Attributes.Add(MethodImplAggressiveInliningAttribute);
                         csStruct.Members.Add(initializeVtbl);
-                        _allGeneratedVtbls.Add(csStruct);
 
                         var ccwFile = $"LibVst.{name}.cs";
                         if (!File.Exists(Path.Combine(_destinationFolder, ccwFile)))
@@ -0,0 +1,251 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using System.Buffers.Binary;
+using System.Numerics;
+
+namespace NPlug.Render;
+
+/// <summary>
+/// Streaming reader for WAV files and raw interleaved 32-bit float files.
+/// Only a block of samples is kept in memory at a time.
+/// </summary>
+internal sealed unsafe class AudioFileReader : IDisposable
+{
+    private const ushort WaveFormatPcm = 1;
+    private const ushort WaveFormatIeeeFloat = 3;
+    private const ushort WaveFormatExtensible = 0xFFFE;
+
+    private readonly Stream _stream;
+    private readonly AudioFileSampleEncoding _encoding;
+    private readonly int _bytesPerSample;
+    private long _remainingBytes;
+    private byte[] _buffer;
+
+    private AudioFileReader(Stream stream, AudioFileSampleEncoding encoding, int channelCount, double sampleRate, long dataLength)
+    {
+        _stream = stream;
+        _encoding = encoding;
+        _bytesPerSample = encoding.GetBytesPerSample();
+        _remainingBytes = dataLength;
+        _buffer = Array.Empty<byte>();
+        ChannelCount = channelCount;
+        SampleRate = sampleRate;
+    }
+
+    public int ChannelCount { get; }
+
+    public double SampleRate { get; }
+
+    public static AudioFileReader Open(string path, AudioRenderOptions options)
+    {
+        var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, 1 << 16, FileOptions.SequentialScan);
+        try
+        {
+            if (AudioFileWriter.IsRawFile(path))
+            {
+                if (options.RawChannelCount <= 0) throw new InvalidOperationException($"Invalid channel count {options.RawChannelCount} for raw file {path}");
+                return new AudioFileReader(stream, AudioFileSampleEncoding.Float32, options.RawChannelCount, options.RawSampleRate, stream.Length);
+            }
+
+            return OpenWave(path, stream);
+        }
+        catch
+        {
+            stream.Dispose();
+            throw;
+        }
+    }
+
+    /// <summary>
+    /// Reads and deinterleaves up to <paramref name="frameCount"/> sample frames into the specified channel buffers.
+    /// Channels of the file beyond <paramref name="channelCount"/> are dropped.
+    /// </summary>
+    /// <returns>The number of sample frames read. 0 when the end of the file has been reached.</returns>
+    public int Read(void** channels, int channelCount, int frameCount, AudioSampleSize sampleSize)
+    {
+        var frameSize = _bytesPerSample * ChannelCount;
+        var count = (int)Math.Min(frameCount, _remainingBytes / frameSize);
+        if (count == 0) return 0;
+
+        var byteCount = count * frameSize;
+        if (_buffer.Length < byteCount)
+        {
+            _buffer = new byte[byteCount];
+        }
+
+        var data = _buffer.AsSpan(0, byteCount);
+        _stream.ReadExactly(data);
+        _remainingBytes -= byteCount;
+
+        var decodedChannelCount = Math.Min(channelCount, ChannelCount);
+        for (int channel = 0; channel < decodedChannelCount; channel++)
+        {
+            if (sampleSize == AudioSampleSize.Float32)
+            {
+                Decode(data, channel, new Span<float>(channels[channel], count));
+            }
+            else
+            {
+                Decode(data, channel, new Span<double>(channels[channel], count));
+            }
+        }
+
+        return count;
+    }
+
+    public void Dispose()
+    {
+        _stream.Dispose();
+    }
+
+    private void Decode<T>(ReadOnlySpan<byte> data, int channel, Span<T> destination) where T : unmanaged, IFloatingPointIeee754<T>
+    {
+        var stride = _bytesPerSample * ChannelCount;
+        var offset = channel * _bytesPerSample;
+        switch (_encoding)
+        {
+            case AudioFileSampleEncoding.Pcm8:
+                for (int i = 0; i < destination.Length; i++, offset += stride)
+                {
+                    destination[i] = T.CreateTruncating((data[offset] - 128) * (1.0 / 128.0));
+                }
+                break;
+            case AudioFileSampleEncoding.Pcm16:
+                for (int i = 0; i < destination.Length; i++, offset += stride)
+                {
+                    destination[i] = T.CreateTruncating(BinaryPrimitives.ReadInt16LittleEndian(data.Slice(offset)) * (1.0 / 32768.0));
+                }
+                break;
+            case AudioFileSampleEncoding.Pcm24:
+                for (int i = 0; i < destination.Length; i++, offset += stride)
+                {
+                    var value = (data[offset] | (data[offset + 1] << 8) | (data[offset + 2] << 16)) << 8 >> 8;
+                    destination[i] = T.CreateTruncating(value * (1.0 / 8388608.0));
+                }
+                break;
+            case AudioFileSampleEncoding.Pcm32:
+                for (int i = 0; i < destination.Length; i++, offset += stride)
+                {
+                    destination[i] = T.CreateTruncating(BinaryPrimitives.ReadInt32LittleEndian(data.Slice(offset)) * (1.0 / 2147483648.0));
+                }
+                break;
+            case AudioFileSampleEncoding.Float32:
+                for (int i = 0; i < destination.Length; i++, offset += stride)
+                {
+                    destination[i] = T.CreateTruncating(BinaryPrimitives.ReadSingleLittleEndian(data.Slice(offset)));
+                }
+                break;
+            case AudioFileSampleEncoding.Float64:
+                for (int i = 0; i < destination.Length; i++, offset += stride)
+                {
+                    destination[i] = T.CreateTruncating(BinaryPrimitives.ReadDoubleLittleEndian(data.Slice(offset)));
+                }
+                break;
+        }
+    }
+
+    private static AudioFileReader OpenWave(string path, Stream stream)
+    {
+        Span<byte> header = stackalloc byte[12];
+        stream.ReadExactly(header);
+        if (!header.Slice(0, 4).SequenceEqual("RIFF"u8) || !header.Slice(8, 4).SequenceEqual("WAVE"u8))
+        {
+            throw new InvalidDataException($"The file {path} is not a valid WAV file");
+        }
+
+        AudioFileSampleEncoding? encoding = null;
+        int channelCount = 0;
+        double sampleRate = 0;
+        Span<byte> chunkHeader = stackalloc byte[8];
+        while (stream.Read(chunkHeader) == chunkHeader.Length)
+        {
+            var chunkSize = BinaryPrimitives.ReadUInt32LittleEndian(chunkHeader.Slice(4));
+            if (chunkHeader.Slice(0, 4).SequenceEqual("fmt "u8))
+            {
+                if (chunkSize < 16) throw new InvalidDataException($"Invalid fmt chunk in WAV file {path}");
+                var format = new byte[chunkSize];
+                stream.ReadExactly(format);
+                var formatTag = BinaryPrimitives.ReadUInt16LittleEndian(format);
+                channelCount = BinaryPrimitives.ReadUInt16LittleEndian(format.AsSpan(2));
+                sampleRate = BinaryPrimitives.ReadUInt32LittleEndian(format.AsSpan(4));
+                var bitsPerSample = BinaryPrimitives.ReadUInt16LittleEndian(format.AsSpan(14));
+                if (formatTag == WaveFormatExtensible && chunkSize >= 40)
+                {
+                    // The first two bytes of the sub format GUID are the actual format tag
+                    formatTag = BinaryPrimitives.ReadUInt16LittleEndian(format.AsSpan(24));
+                }
+                encoding = GetEncoding(formatTag, bitsPerSample) ?? throw new NotSupportedException($"Unsupported WAV format {formatTag} with {bitsPerSample} bits per sample in {path}");
+                SkipPadding(stream, chunkSize);
+            }
+            else if (chunkHeader.Slice(0, 4).SequenceEqual("data"u8))
+            {
+                if (encoding is null || channelCount == 0) throw new InvalidDataException($"Missing fmt chunk before the data chunk in WAV file {path}");
+                // Streamed WAV files might have an invalid data size
+                var dataLength = Math.Min(chunkSize, stream.Length - stream.Position);
+                return new AudioFileReader(stream, encoding.Value, channelCount, sampleRate, dataLength);
+            }
+            else
+            {
+                stream.Seek(chunkSize, SeekOrigin.Current);
+                SkipPadding(stream, chunkSize);
+            }
+        }
+
+        throw new InvalidDataException($"Missing data chunk in WAV file {path}");
+    }
+
+    private static void SkipPadding(Stream stream, uint chunkSize)
+    {
+        // RIFF chunks are aligned on 2 bytes
+        if ((chunkSize & 1) != 0)
+        {
+            stream.Seek(1, SeekOrigin.Current);
+        }
+    }
+
+    private static AudioFileSampleEncoding? GetEncoding(ushort formatTag, ushort bitsPerSample)
+    {
+        return (formatTag, bitsPerSample) switch
+        {
+            (WaveFormatPcm, 8) => AudioFileSampleEncoding.Pcm8,
+            (WaveFormatPcm, 16) => AudioFileSampleEncoding.Pcm16,
+            (WaveFormatPcm, 24) => AudioFileSampleEncoding.Pcm24,
+            (WaveFormatPcm, 32) => AudioFileSampleEncoding.Pcm32,
+            (WaveFormatIeeeFloat, 32) => AudioFileSampleEncoding.Float32,
+            (WaveFormatIeeeFloat, 64) => AudioFileSampleEncoding.Float64,
+            _ => null
+        };
+    }
+}
+
+/// <summary>
+/// Encoding of the samples in an audio file.
+/// </summary>
+internal enum AudioFileSampleEncoding
+{
+    Pcm8,
+    Pcm16,
+    Pcm24,
+    Pcm32,
+    Float32,
+    Float64,
+}
+
+internal static class AudioFileSampleEncodingExtensions
+{
+    public static int GetBytesPerSample(this AudioFileSampleEncoding encoding)
+    {
+        return encoding switch
+        {
+            AudioFileSampleEncoding.Pcm8 => 1,
+            AudioFileSampleEncoding.Pcm16 => 2,
+            AudioFileSampleEncoding.Pcm24 => 3,
+            AudioFileSampleEncoding.Pcm32 => 4,
+            AudioFileSampleEncoding.Float32 => 4,
+            AudioFileSampleEncoding.Float64 => 8,
+            _ => throw new ArgumentOutOfRangeException(nameof(encoding), encoding, null)
+        };
+    }
+}
@@ -0,0 +1,213 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using System.Buffers.Binary;
+using System.Numerics;
+
+namespace NPlug.Render;
+
+/// <summary>
+/// Streaming writer for WAV files and raw interleaved 32-bit float files.
+/// </summary>
+/// <remarks>
+/// WAV files with more than 2 channels or more than 16 bits per sample are written with <c>WAVE_FORMAT_EXTENSIBLE</c>,
+/// and IEEE float files have a <c>fact</c> chunk, as required by the WAV specification.
+/// </remarks>
+internal sealed unsafe class AudioFileWriter : IDisposable
+{
+    private const ushort WaveFormatPcm = 1;
+    private const ushort WaveFormatIeeeFloat = 3;
+    private const ushort WaveFormatExtensible = 0xFFFE;
+    private const int RiffHeaderSize = 12;
+    private const int ChunkHeaderSize = 8;
+    private const int FormatSize = 16;
+    private const int FormatExtensibleSize = 40;
+    private const int FactSize = 4;
+
+    private readonly Stream _stream;
+    private readonly AudioFileSampleEncoding _encoding;
+    private readonly int _bytesPerSample;
+    private readonly int _channelCount;
+    private readonly double _sampleRate;
+    private readonly bool _isRaw;
+    private readonly bool _isExtensible;
+    private readonly int _headerSize;
+    private long _dataLength;
+    private byte[] _buffer;
+
+    private AudioFileWriter(Stream stream, AudioFileSampleEncoding encoding, int channelCount, double sampleRate, bool isRaw)
+    {
+        _stream = stream;
+        _encoding = encoding;
+        _bytesPerSample = encoding.GetBytesPerSample();
+        _channelCount = channelCount;
+        _sampleRate = sampleRate;
+        _isRaw = isRaw;
+        _buffer = Array.Empty<byte>();
+        if (!isRaw)
+        {
+            _isExtensible = channelCount > 2 || _bytesPerSample > 2;
+            _headerSize = RiffHeaderSize + ChunkHeaderSize + (_isExtensible ? FormatExtensibleSize : FormatSize) + (IsFloat ? ChunkHeaderSize + FactSize : 0) + ChunkHeaderSize;
+        }
+    }
+
+    private bool IsFloat => _encoding == AudioFileSampleEncoding.Float32;
+
+    public static bool IsRawFile(string path) => string.Equals(Path.GetExtension(path), ".raw", StringComparison.OrdinalIgnoreCase);
+
+    public static AudioFileWriter Create(string path, int channelCount, double sampleRate, AudioRenderFileFormat format)
+    {
+        var isRaw = IsRawFile(path);
+        var encoding = isRaw ? AudioFileSampleEncoding.Float32 : format switch
+        {
+            AudioRenderFileFormat.Pcm16 => AudioFileSampleEncoding.Pcm16,
+            AudioRenderFileFormat.Pcm24 => AudioFileSampleEncoding.Pcm24,
+            _ => AudioFileSampleEncoding.Float32
+        };
+
+        var stream = new FileStream(path, FileMode.Create, FileAccess.Write, FileShare.None, 1 << 16);
+        var writer = new AudioFileWriter(stream, encoding, channelCount, sampleRate, isRaw);
+        if (!isRaw)
+        {
+            // Reserve the header, it is written when the file is disposed
+            stream.Write(stackalloc byte[writer._headerSize]);
+        }
+        return writer;
+    }
+
+    /// <summary>
+    /// Interleaves and writes <paramref name="frameCount"/> sample frames from the specified channel buffers, starting at <paramref name="frameOffset"/>.
+    /// </summary>
+    public void Write(void** channels, int frameOffset, int frameCount, AudioSampleSize sampleSize)
+    {
+        if (frameCount <= 0) return;
+
+        var byteCount = frameCount * _bytesPerSample * _channelCount;
+        if (_buffer.Length < byteCount)
+        {
+            _buffer = new byte[byteCount];
+        }
+
+        var data = _buffer.AsSpan(0, byteCount);
+        for (int channel = 0; channel < _channelCount; channel++)
+        {
+            if (sampleSize == AudioSampleSize.Float32)
+            {
+                Encode(new ReadOnlySpan<float>((float*)channels[channel] + frameOffset, frameCount), channel, data);
+            }
+            else
+            {
+                Encode(new ReadOnlySpan<double>((double*)channels[channel] + frameOffset, frameCount), channel, data);
+            }
+        }
+
+        _stream.Write(data);
+        _dataLength += byteCount;
+    }
+
+    public void Dispose()
+    {
+        if (!_isRaw)
+        {
+            // RIFF chunks are aligned on 2 bytes
+            if ((_dataLength & 1) != 0)
+            {
+                _stream.WriteByte(0);
+            }
+            WriteWaveHeader();
+        }
+        _stream.Dispose();
+    }
+
+    private void Encode<T>(ReadOnlySpan<T> source, int channel, Span<byte> data) where T : unmanaged, IFloatingPointIeee754<T>
+    {
+        var stride = _bytesPerSample * _channelCount;
+        var offset = channel * _bytesPerSample;
+        switch (_encoding)
+        {
+            case AudioFileSampleEncoding.Pcm16:
+                for (int i = 0; i < source.Length; i++, offset += stride)
+                {
+                    var value = (short)Math.Round(Math.Clamp(double.CreateTruncating(source[i]), -1.0, 1.0) * short.MaxValue);
+                    BinaryPrimitives.WriteInt16LittleEndian(data.Slice(offset), value);
+                }
+                break;
+            case AudioFileSampleEncoding.Pcm24:
+                for (int i = 0; i < source.Length; i++, offset += stride)
+                {
+                    var value = (int)Math.Round(Math.Clamp(double.CreateTruncating(source[i]), -1.0, 1.0) * 8388607.0);
+                    data[offset] = (byte)value;
+                    data[offset + 1] = (byte)(value >> 8);
+                    data[offset + 2] = (byte)(value >> 16);
+                }
+                break;
+            default:
+                for (int i = 0; i < source.Length; i++, offset += stride)
+                {
+                    BinaryPrimitives.WriteSingleLittleEndian(data.Slice(offset), float.CreateTruncating(source[i]));
+                }
+                break;
+        }
+    }
+
+    private void WriteWaveHeader()
+    {
+        var blockAlign = (ushort)(_bytesPerSample * _channelCount);
+        var dataLength = (uint)Math.Min(_dataLength, uint.MaxValue - _headerSize - 1);
+        var formatTag = IsFloat ? WaveFormatIeeeFloat : WaveFormatPcm;
+
+        Span<byte> header = stackalloc byte[_headerSize];
+        "RIFF"u8.CopyTo(header);
+        BinaryPrimitives.WriteUInt32LittleEndian(header.Slice(4), (uint)(_headerSize - 8) + dataLength + (dataLength & 1));
+        "WAVE"u8.CopyTo(header.Slice(8));
+
+        var chunk = header.Slice(RiffHeaderSize);
+        "fmt "u8.CopyTo(chunk);
+        BinaryPrimitives.WriteUInt32LittleEndian(chunk.Slice(4), (uint)(_isExtensible ? FormatExtensibleSize : FormatSize));
+        var format = chunk.Slice(ChunkHeaderSize);
+        BinaryPrimitives.WriteUInt16LittleEndian(format, _isExtensible ? WaveFormatExtensible : formatTag);
+        BinaryPrimitives.WriteUInt16LittleEndian(format.Slice(2), (ushort)_channelCount);
+        BinaryPrimitives.WriteUInt32LittleEndian(format.Slice(4), (uint)_sampleRate);
+        BinaryPrimitives.WriteUInt32LittleEndian(format.Slice(8), (uint)_sampleRate * blockAlign);
+        BinaryPrimitives.WriteUInt16LittleEndian(format.Slice(12), blockAlign);
+        BinaryPrimitives.WriteUInt16LittleEndian(format.Slice(14), (ushort)(_bytesPerSample * 8));
+        if (_isExtensible)
+        {
+            BinaryPrimitives.WriteUInt16LittleEndian(format.Slice(16), 22);
+            BinaryPrimitives.WriteUInt16LittleEndian(format.Slice(18), (ushort)(_bytesPerSample * 8));
+            BinaryPrimitives.WriteUInt32LittleEndian(format.Slice(20), GetChannelMask(_channelCount));
+            // The sub format GUID is {0000xxxx-0000-0010-8000-00AA00389B71} where xxxx is the format tag
+            BinaryPrimitives.WriteUInt16LittleEndian(format.Slice(24), formatTag);
+            ReadOnlySpan<byte> subFormatSuffix = [0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71];
+            subFormatSuffix.CopyTo(format.Slice(26));
+        }
+        chunk = chunk.Slice(ChunkHeaderSize + (_isExtensible ? FormatExtensibleSize : FormatSize));
+
+        if (IsFloat)
+        {
+            // The fact chunk is required for non-PCM formats and contains the number of sample frames
+            "fact"u8.CopyTo(chunk);
+            BinaryPrimitives.WriteUInt32LittleEndian(chunk.Slice(4), FactSize);
+            BinaryPrimitives.WriteUInt32LittleEndian(chunk.Slice(8), dataLength / blockAlign);
+            chunk = chunk.Slice(ChunkHeaderSize + FactSize);
+        }
+
+        "data"u8.CopyTo(chunk);
+        BinaryPrimitives.WriteUInt32LittleEndian(chunk.Slice(4), dataLength);
+
+        _stream.Position = 0;
+        _stream.Write(header);
+    }
+
+    private static uint GetChannelMask(int channelCount)
+    {
+        // Default speaker positions of WAVE_FORMAT_EXTENSIBLE (SPEAKER_FRONT_CENTER for mono, then SPEAKER_FRONT_LEFT, SPEAKER_FRONT_RIGHT...)
+        return channelCount switch
+        {
+            1 => 0x4,
+            <= 18 => (1U << channelCount) - 1,
+            _ => 0
+        };
+    }
+}
@@ -0,0 +1,431 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using System.Globalization;
+using System.Numerics;
+
+namespace NPlug.Render;
+
+/// <summary>
+/// Renders audio files offline through a plugin, using <see cref="AudioProcessMode.Offline"/>.
+/// Each file is rendered on its own plugin instance, and files are dispatched to a pool of worker threads.
+/// </summary>
+/// <remarks>
+/// The input file is sent to the first audio input bus and the output file is written from the first audio output bus.
+/// The other buses are activated and processed, but their inputs are silent and their outputs are discarded.
+/// The output file is written to a temporary file next to it and only replaces the output file once the rendering is complete,
+/// so that a failed rendering doesn't leave a partial file.
+/// </remarks>
+public static class AudioPluginRenderer
+{
+    /// <summary>
+    /// The name of the host application passed to the plugin instances.
+    /// </summary>
+    public const string HostName = "NPlug.Render";
+
+    /// <summary>
+    /// Renders the specified jobs with the plugin from the specified factory.
+    /// </summary>
+    /// <param name="factory">The factory of the plugin.</param>
+    /// <param name="jobs">The list of files to render.</param>
+    /// <param name="options">The options of the rendering.</param>
+    /// <param name="completed">An optional callback called (from a worker thread) when a job is completed.</param>
+    /// <returns>The results of the jobs, in the same order as <paramref name="jobs"/>.</returns>
+    public static AudioRenderResult[] Render(AudioPluginFactory factory, IReadOnlyList<AudioRenderJob> jobs, AudioRenderOptions options, Action<AudioRenderResult>? completed = null)
+    {
+        ArgumentNullException.ThrowIfNull(factory);
+        ArgumentNullException.ThrowIfNull(jobs);
+        ArgumentNullException.ThrowIfNull(options);
+        if (options.BlockSize <= 0) throw new ArgumentException($"Invalid block size {options.BlockSize}", nameof(options));
+
+        var classId = options.ClassId ?? factory.PluginClassInfos.OfType<AudioProcessorClassInfo>().FirstOrDefault()?.ClassId ?? throw new ArgumentException("The factory does not contain any audio processor", nameof(factory));
+
+        var results = new AudioRenderResult[jobs.Count];
+        var queue = new ConcurrentQueue<int>(Enumerable.Range(0, jobs.Count));
+        var workerCount = Math.Clamp(options.MaxDegreeOfParallelism, 1, Math.Max(1, jobs.Count));
+        var workers = new Thread[workerCount];
+        for (int i = 0; i < workers.Length; i++)
+        {
+            workers[i] = new Thread(() =>
+            {
+                while (queue.TryDequeue(out var index))
+                {
+                    var result = RenderJob(factory, classId, jobs[index], options);
+                    results[index] = result;
+                    completed?.Invoke(result);
+                }
+            })
+            {
+                Name = $"{HostName} Worker #{i}",
+                IsBackground = true
+            };
+            workers[i].Start();
+        }
+
+        foreach (var worker in workers)
+        {
+            worker.Join();
+        }
+
+        return results;
+    }
+
+    /// <summary>
+    /// Reads the processor state from a <c>.vstpreset</c> file.
+    /// </summary>
+    /// <param name="presetPath">The path to the preset file.</param>
+    /// <returns>The state of the processor that can be passed to <see cref="AudioRenderOptions.State"/>.</returns>
+    public static byte[] ReadPresetState(string presetPath)
+    {
+        using var stream = File.OpenRead(presetPath);
+        using var reader = new BinaryReader(stream);
+
+        // Header: 'VST3', version, class id (32 ASCII chars), offset to the chunk list
+        if (!reader.ReadBytes(4).AsSpan().SequenceEqual("VST3"u8)) throw new InvalidDataException($"The file {presetPath} is not a valid VST3 preset");
+        reader.ReadInt32();
+        reader.ReadBytes(32);
+        stream.Position = reader.ReadInt64();
+
+        if (!reader.ReadBytes(4).AsSpan().SequenceEqual("List"u8)) throw new InvalidDataException($"Invalid chunk list in VST3 preset {presetPath}");
+        var entryCount = reader.ReadInt32();
+        for (int i = 0; i < entryCount; i++)
+        {
+            var id = reader.ReadBytes(4);
+            var offset = reader.ReadInt64();
+            var size = reader.ReadInt64();
+            if (id.AsSpan().SequenceEqual("Comp"u8))
+            {
+                stream.Position = offset;
+                return reader.ReadBytes(checked((int)size));
+            }
+        }
+
+        throw new InvalidDataException($"The VST3 preset {presetPath} does not contain a processor state");
+    }
+
+    /// <summary>
+    /// Runs the renderer from command line arguments. This can be used to create a render command line tool for a plugin:
+    /// <code>
+    /// return AudioPluginRenderer.Run(MyPlugin.GetFactory(), args, Console.Out, Console.Error);
+    /// </code>
+    /// </summary>
+    /// <param name="factory">The factory of the plugin.</param>
+    /// <param name="args">The command line arguments.</param>
+    /// <param name="output">The writer to log the progress.</param>
+    /// <param name="error">The writer to log the errors.</param>
+    /// <returns>0 if all the files were successfully rendered; 1 otherwise.</returns>
+    public static int Run(AudioPluginFactory factory, string[] args, TextWriter output, TextWriter error)
+    {
+        var options = new AudioRenderOptions();
+        var inputs = new List<string>();
+        string? outputDirectory = null;
+        try
+        {
+            for (int i = 0; i < args.Length; i++)
+            {
+                var arg = args[i];
+                switch (arg)
+                {
+                    case "-o":
+                    case "--output":
+                        outputDirectory = GetValue(args, ref i);
+                        break;
+                    case "--class":
+                        options.ClassId = Guid.Parse(GetValue(args, ref i));
+                        break;
+                    case "--state":
+                        options.State = File.ReadAllBytes(GetValue(args, ref i));
+                        break;
+                    case "--preset":
+                        options.State = ReadPresetState(GetValue(args, ref i));
+                        break;
+                    case "--block-size":
+                        options.BlockSize = ParseValue<int>(args, ref i);
+                        break;
+                    case "--sample-size":
+                        options.SampleSize = ParseValue<int>(args, ref i) switch
+                        {
+                            32 => AudioSampleSize.Float32,
+                            64 => AudioSampleSize.Float64,
+                            _ => throw new ArgumentException("Invalid sample size. Expecting 32 or 64")
+                        };
+                        break;
+                    case "-j":
+                    case "--jobs":
+                        options.MaxDegreeOfParallelism = ParseValue<int>(args, ref i);
+                        break;
+                    case "--format":
+                        options.OutputFormat = Enum.Parse<AudioRenderFileFormat>(GetValue(args, ref i), true);
+                        break;
+                    case "--raw-sample-rate":
+                        options.RawSampleRate = ParseValue<double>(args, ref i);
+                        break;
+                    case "--raw-channels":
+                        options.RawChannelCount = ParseValue<int>(args, ref i);
+                        break;
+                    case "--max-tail":
+                        options.MaxTailSeconds = ParseValue<double>(args, ref i);
+                        break;
+                    case "-h":
+                    case "--help":
+                        PrintUsage(output);
+                        return 0;
+                    default:
+                        if (arg.StartsWith('-')) throw new ArgumentException($"Unknown option {arg}");
+                        if (Directory.Exists(arg))
+                        {
+                            inputs.AddRange(Directory.EnumerateFiles(arg, "*.wav").Concat(Directory.EnumerateFiles(arg, "*.raw")).Order(StringComparer.Ordinal));
+                        }
+                        else
+                        {
+                            inputs.Add(arg);
+                        }
+                        break;
+                }
+            }
+
+            if (inputs.Count == 0 || outputDirectory is null) throw new ArgumentException("Missing input files or output directory");
+        }
+        catch (Exception ex) when (ex is ArgumentException or FormatException or IOException or InvalidDataException)
+        {
+            error.WriteLine($"Error: {ex.Message}");
+            PrintUsage(error);
+            return 1;
+        }
+
+        Directory.CreateDirectory(outputDirectory);
+        var jobs = new List<AudioRenderJob>();
+        foreach (var input in inputs)
+        {
+            var extension = AudioFileWriter.IsRawFile(input) ? ".raw" : ".wav";
+            var outputPath = Path.Combine(outputDirectory, Path.GetFileNameWithoutExtension(input) + extension);
+            if (string.Equals(Path.GetFullPath(input), Path.GetFullPath(outputPath), StringComparison.OrdinalIgnoreCase))
+            {
+                error.WriteLine($"Error: The output file {outputPath} would overwrite its input");
+                return 1;
+            }
+            jobs.Add(new AudioRenderJob(input, outputPath));
+        }
+
+        var stopwatch = Stopwatch.StartNew();
+        var results = Render(factory, jobs, options, result =>
+        {
+            lock (output)
+            {
+                if (result.Success)
+                {
+                    output.WriteLine(string.Create(CultureInfo.InvariantCulture, $"{result.Job.InputPath} -> {result.Job.OutputPath}: {result.AudioDuration.TotalSeconds:0.00}s processed in {result.ProcessElapsed.TotalSeconds:0.00}s ({result.RealtimeFactor:0.0}x realtime), {result.Elapsed.TotalSeconds:0.00}s in total"));
+                }
+                else
+                {
+                    error.WriteLine($"Error rendering {result.Job.InputPath}: {result.Error}");
+                }
+            }
+        });
+        stopwatch.Stop();
+
+        var totalAudioSeconds = results.Where(x => x.Success).Sum(x => x.AudioDuration.TotalSeconds);
+        var failedCount = results.Count(x => !x.Success);
+        output.WriteLine(string.Create(CultureInfo.InvariantCulture, $"Rendered {results.Length - failedCount}/{results.Length} files, {totalAudioSeconds:0.00}s of audio in {stopwatch.Elapsed.TotalSeconds:0.00}s ({totalAudioSeconds / stopwatch.Elapsed.TotalSeconds:0.0}x realtime)"));
+        return failedCount == 0 ? 0 : 1;
+    }
+
+    private static void PrintUsage(TextWriter writer)
+    {
+        writer.WriteLine("Usage: <input files or directories...> --output <directory> [options]");
+        writer.WriteLine("  --class <guid>            Class id of the processor (default is the first processor of the factory)");
+        writer.WriteLine("  --state <file>            Processor state to restore before rendering");
+        writer.WriteLine("  --preset <file.vstpreset> VST3 preset to restore before rendering");
+        writer.WriteLine("  --block-size <samples>    Number of samples per block (default 8192)");
+        writer.WriteLine("  --sample-size <32|64>     Processing sample size (default 32)");
+        writer.WriteLine("  --jobs <count>            Number of files rendered in parallel (default is the number of cores)");
+        writer.WriteLine("  --format <format>         Output WAV format: float32, pcm16 or pcm24 (default float32)");
+        writer.WriteLine("  --raw-sample-rate <rate>  Sample rate of raw input files (default 48000)");
+        writer.WriteLine("  --raw-channels <count>    Channel count of raw input files (default 2)");
+        writer.WriteLine("  --max-tail <seconds>      Maximum tail rendered for plugins with an infinite tail (default 10)");
+    }
+
+    private static string GetValue(string[] args, ref int index)
+    {
+        if (index + 1 >= args.Length) throw new ArgumentException($"Missing value for option {args[index]}");
+        return args[++index];
+    }
+
+    private static T ParseValue<T>(string[] args, ref int index) where T : INumber<T>
+    {
+        return T.Parse(GetValue(args, ref index), CultureInfo.InvariantCulture);
+    }
+
+    private static AudioRenderResult RenderJob(AudioPluginFactory factory, Guid classId, AudioRenderJob job, AudioRenderOptions options)
+    {
+        var result = new AudioRenderResult(job);
+        var stopwatch = Stopwatch.StartNew();
+        // Keep the extension of the output file, as it selects the format of the file
+        var temporaryPath = Path.ChangeExtension(job.OutputPath, $".{Guid.NewGuid():N}.tmp{Path.GetExtension(job.OutputPath)}");
+        try
+        {
+            using var reader = AudioFileReader.Open(job.InputPath, options);
+            result.SampleRate = reader.SampleRate;
+
+            var processor = factory.CreateInstance(classId) as IAudioProcessor ?? throw new InvalidOperationException($"The class {classId} is not an audio processor");
+            if (!processor.Initialize(new AudioOfflineHostApplication(HostName)))
+            {
+                throw new InvalidOperationException($"Unable to initialize the processor {classId}");
+            }
+
+            try
+            {
+                Render(processor, reader, temporaryPath, options, result);
+            }
+            finally
+            {
+                processor.Terminate();
+            }
+
+            File.Move(temporaryPath, job.OutputPath, true);
+        }
+        catch (Exception ex)
+        {
+            result.Error = ex.Message;
+            TryDeleteFile(temporaryPath);
+        }
+
+        result.Elapsed = stopwatch.Elapsed;
+        return result;
+    }
+
+    private static void TryDeleteFile(string path)
+    {
+        try
+        {
+            File.Delete(path);
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            // Ignore: the rendering error is more relevant than this one
+        }
+    }
+
+    private static unsafe void Render(IAudioProcessor processor, AudioFileReader reader, string outputPath, AudioRenderOptions options, AudioRenderResult result)
+    {
+        if (options.State is { } state)
+        {
+            processor.SetState(new MemoryStream(state, false));
+        }
+
+        var inputBusCount = processor.GetBusCount(BusMediaType.Audio, BusDirection.Input);
+        var outputBusCount = processor.GetBusCount(BusMediaType.Audio, BusDirection.Output);
+        if (outputBusCount == 0) throw new InvalidOperationException("The processor does not have any audio output bus");
+
+        // Try to match the channel count of the input file, otherwise keep the default arrangement of the processor
+        var arrangement = GetSpeakerArrangement(reader.ChannelCount);
+        var inputArrangements = new SpeakerArrangement[inputBusCount];
+        var outputArrangements = new SpeakerArrangement[outputBusCount];
+        Array.Fill(inputArrangements, arrangement);
+        Array.Fill(outputArrangements, arrangement);
+        processor.SetBusArrangements(inputArrangements, outputArrangements);
+
+        var inputChannelCounts = ActivateBuses(processor, BusDirection.Input, inputBusCount);
+        var outputChannelCounts = ActivateBuses(processor, BusDirection.Output, outputBusCount);
+
+        var sampleSize = options.SampleSize == AudioSampleSize.Float64 && processor.CanProcessSampleSize(AudioSampleSize.Float64) ? AudioSampleSize.Float64 : AudioSampleSize.Float32;
+        if (!processor.CanProcessSampleSize(sampleSize)) throw new InvalidOperationException($"The processor does not support the sample size {sampleSize}");
+
+        var blockSize = options.BlockSize;
+        if (!processor.SetupProcessing(new AudioProcessSetupData(AudioProcessMode.Offline, sampleSize, blockSize, reader.SampleRate)))
+        {
+            throw new InvalidOperationException("The processor failed to setup processing");
+        }
+
+        using var buffers = new AudioRenderBuffers(inputChannelCounts, outputChannelCounts, blockSize, sampleSize);
+        using var writer = AudioFileWriter.Create(outputPath, outputChannelCounts[0], reader.SampleRate, options.OutputFormat);
+
+        // Compensate the latency of the processor and render its tail after the end of the input
+        var latency = (long)processor.LatencySamples;
+        var maxTail = (long)(options.MaxTailSeconds * reader.SampleRate);
+        var tail = processor.TailSamples == uint.MaxValue ? maxTail : Math.Min(processor.TailSamples, maxTail);
+        var remainingFlush = latency + tail;
+        var remainingSkip = latency;
+        var inputChannelCount = inputBusCount > 0 ? inputChannelCounts[0] : 0;
+        long processTicks = 0;
+
+        processor.SetActive(true);
+        processor.SetProcessing(true);
+        try
+        {
+            while (true)
+            {
+                if (inputChannelCount > reader.ChannelCount)
+                {
+                    buffers.ClearInput(0, 0, blockSize);
+                }
+
+                // When the processor has no input, the input file is still read to drive the length of the output
+                var count = reader.Read(inputBusCount > 0 ? buffers.Inputs[0].ChannelBuffers : null, inputChannelCount, blockSize, sampleSize);
+                if (count > 0)
+                {
+                    result.InputSampleCount += count;
+                    if (inputBusCount > 0)
+                    {
+                        buffers.Inputs[0].SilenceFlags = 0;
+                    }
+                }
+                else
+                {
+                    if (remainingFlush <= 0) break;
+
+                    count = (int)Math.Min(blockSize, remainingFlush);
+                    remainingFlush -= count;
+                    if (inputBusCount > 0)
+                    {
+                        buffers.ClearInput(0, 0, count);
+                        buffers.Inputs[0].SilenceFlags = inputChannelCount >= 64 ? ulong.MaxValue : (1UL << inputChannelCount) - 1;
+                    }
+                }
+
+                var processData = new AudioProcessData(IntPtr.Zero, AudioProcessMode.Offline, sampleSize, count,
+                    new AudioBusData(inputBusCount, (AudioBusBuffers*)buffers.Inputs, default, default),
+                    new AudioBusData(outputBusCount, (AudioBusBuffers*)buffers.Outputs, default, default));
+                var startTimestamp = Stopwatch.GetTimestamp();
+                processor.Process(in processData);
+                processTicks += Stopwatch.GetTimestamp() - startTimestamp;
+
+                var skip = (int)Math.Min(remainingSkip, count);
+                remainingSkip -= skip;
+                writer.Write(buffers.Outputs[0].ChannelBuffers, skip, count - skip, sampleSize);
+                result.OutputSampleCount += count - skip;
+            }
+        }
+        finally
+        {
+            result.ProcessElapsed = Stopwatch.GetElapsedTime(0, processTicks);
+            processor.SetProcessing(false);
+            processor.SetActive(false);
+        }
+    }
+
+    private static int[] ActivateBuses(IAudioProcessor processor, BusDirection direction, int busCount)
+    {
+        var channelCounts = new int[busCount];
+        for (int i = 0; i < busCount; i++)
+        {
+            channelCounts[i] = processor.GetBusInfo(BusMediaType.Audio, direction, i).ChannelCount;
+            processor.ActivateBus(BusMediaType.Audio, direction, i, true);
+        }
+        return channelCounts;
+    }
+
+    private static SpeakerArrangement GetSpeakerArrangement(int channelCount)
+    {
+        return channelCount switch
+        {
+            1 => SpeakerArrangement.SpeakerMono,
+            2 => SpeakerArrangement.SpeakerStereo,
+            >= 64 => (SpeakerArrangement)ulong.MaxValue,
+            _ => (SpeakerArrangement)((1UL << channelCount) - 1)
+        };
+    }
+}
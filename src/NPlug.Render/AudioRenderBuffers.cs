@@ -0,0 +1,104 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using System.Runtime.InteropServices;
+
+namespace NPlug.Render;
+
+/// <summary>
+/// Native audio buffers for the input and output buses of a processor, allocated once per rendering.
+/// </summary>
+internal sealed unsafe class AudioRenderBuffers : IDisposable
+{
+    private const int Alignment = 64;
+
+    private readonly int _bytesPerSample;
+    private readonly int _blockSize;
+
+    public AudioRenderBuffers(int[] inputChannelCounts, int[] outputChannelCounts, int blockSize, AudioSampleSize sampleSize)
+    {
+        _blockSize = blockSize;
+        _bytesPerSample = sampleSize == AudioSampleSize.Float32 ? sizeof(float) : sizeof(double);
+        InputBusCount = inputChannelCounts.Length;
+        OutputBusCount = outputChannelCounts.Length;
+        Inputs = Allocate(inputChannelCounts);
+        Outputs = Allocate(outputChannelCounts);
+    }
+
+    public int InputBusCount { get; }
+
+    public int OutputBusCount { get; }
+
+    public NativeAudioBusBuffers* Inputs { get; private set; }
+
+    public NativeAudioBusBuffers* Outputs { get; private set; }
+
+    /// <summary>
+    /// Clears <paramref name="frameCount"/> samples starting at <paramref name="frameOffset"/> for all the channels of the specified input bus.
+    /// </summary>
+    public void ClearInput(int busIndex, int frameOffset, int frameCount)
+    {
+        ref var bus = ref Inputs[busIndex];
+        for (int channel = 0; channel < bus.ChannelCount; channel++)
+        {
+            new Span<byte>((byte*)bus.ChannelBuffers[channel] + frameOffset * _bytesPerSample, frameCount * _bytesPerSample).Clear();
+        }
+    }
+
+    public void Dispose()
+    {
+        Free(Inputs, InputBusCount);
+        Free(Outputs, OutputBusCount);
+        Inputs = null;
+        Outputs = null;
+    }
+
+    private NativeAudioBusBuffers* Allocate(int[] channelCounts)
+    {
+        var buses = (NativeAudioBusBuffers*)NativeMemory.AllocZeroed((nuint)Math.Max(1, channelCounts.Length), (nuint)sizeof(NativeAudioBusBuffers));
+        for (int busIndex = 0; busIndex < channelCounts.Length; busIndex++)
+        {
+            ref var bus = ref buses[busIndex];
+            var channelCount = channelCounts[busIndex];
+            bus.ChannelCount = channelCount;
+            bus.ChannelBuffers = (void**)NativeMemory.AllocZeroed((nuint)Math.Max(1, channelCount), (nuint)sizeof(void*));
+            for (int channel = 0; channel < channelCount; channel++)
+            {
+                var size = (nuint)(_blockSize * _bytesPerSample);
+                var buffer = NativeMemory.AlignedAlloc(size, Alignment);
+                NativeMemory.Clear(buffer, size);
+                bus.ChannelBuffers[channel] = buffer;
+            }
+        }
+        return buses;
+    }
+
+    private static void Free(NativeAudioBusBuffers* buses, int busCount)
+    {
+        if (buses == null) return;
+        for (int busIndex = 0; busIndex < busCount; busIndex++)
+        {
+            ref var bus = ref buses[busIndex];
+            for (int channel = 0; channel < bus.ChannelCount; channel++)
+            {
+                NativeMemory.AlignedFree(bus.ChannelBuffers[channel]);
+            }
+            NativeMemory.Free(bus.ChannelBuffers);
+        }
+        NativeMemory.Free(buses);
+    }
+}
+
+/// <summary>
+/// Native layout of the VST3 AudioBusBuffers, matching <see cref="AudioBusBuffers"/>.
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+internal unsafe struct NativeAudioBusBuffers
+{
+    public int ChannelCount;
+
+    public ulong SilenceFlags;
+
+    public void** ChannelBuffers;
+}
@@ -0,0 +1,26 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+namespace NPlug.Render;
+
+/// <summary>
+/// The sample format of a rendered output file.
+/// </summary>
+public enum AudioRenderFileFormat
+{
+    /// <summary>
+    /// 32-bit IEEE floating point samples.
+    /// </summary>
+    Float32,
+
+    /// <summary>
+    /// 16-bit signed integer PCM samples.
+    /// </summary>
+    Pcm16,
+
+    /// <summary>
+    /// 24-bit signed integer PCM samples.
+    /// </summary>
+    Pcm24,
+}
@@ -0,0 +1,12 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+namespace NPlug.Render;
+
+/// <summary>
+/// A file to render through a plugin.
+/// </summary>
+/// <param name="InputPath">The path to the input file (WAV or raw interleaved 32-bit float).</param>
+/// <param name="OutputPath">The path to the output file. A file with a <c>.raw</c> extension is written as raw interleaved 32-bit float.</param>
+public record AudioRenderJob(string InputPath, string OutputPath);
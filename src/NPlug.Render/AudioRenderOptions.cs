@@ -0,0 +1,62 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+namespace NPlug.Render;
+
+/// <summary>
+/// Options used by <see cref="AudioPluginRenderer"/>.
+/// </summary>
+public sealed class AudioRenderOptions
+{
+    /// <summary>
+    /// Gets or sets the class id of the processor to render with. If <c>null</c>, the first processor registered in the factory is used.
+    /// </summary>
+    public Guid? ClassId { get; set; }
+
+    /// <summary>
+    /// Gets or sets the state to restore on each plugin instance before rendering (as saved by <see cref="IAudioProcessor.GetState"/>).
+    /// </summary>
+    /// <remarks>
+    /// Use <see cref="AudioPluginRenderer.ReadPresetState"/> to load the state from a <c>.vstpreset</c> file.
+    /// </remarks>
+    public byte[]? State { get; set; }
+
+    /// <summary>
+    /// Gets or sets the number of samples processed per block. Default is 8192.
+    /// </summary>
+    public int BlockSize { get; set; } = 8192;
+
+    /// <summary>
+    /// Gets or sets the sample size used for processing. Default is <see cref="AudioSampleSize.Float32"/>.
+    /// </summary>
+    /// <remarks>
+    /// If the plugin does not support <see cref="AudioSampleSize.Float64"/>, <see cref="AudioSampleSize.Float32"/> is used.
+    /// </remarks>
+    public AudioSampleSize SampleSize { get; set; } = AudioSampleSize.Float32;
+
+    /// <summary>
+    /// Gets or sets the maximum number of files rendered in parallel, each one on its own plugin instance. Default is <see cref="Environment.ProcessorCount"/>.
+    /// </summary>
+    public int MaxDegreeOfParallelism { get; set; } = Environment.ProcessorCount;
+
+    /// <summary>
+    /// Gets or sets the format of the output WAV files. Default is <see cref="AudioRenderFileFormat.Float32"/>.
+    /// </summary>
+    public AudioRenderFileFormat OutputFormat { get; set; } = AudioRenderFileFormat.Float32;
+
+    /// <summary>
+    /// Gets or sets the sample rate of raw input files. Default is 48000.
+    /// </summary>
+    public double RawSampleRate { get; set; } = 48000.0;
+
+    /// <summary>
+    /// Gets or sets the number of channels of raw input files. Default is 2.
+    /// </summary>
+    public int RawChannelCount { get; set; } = 2;
+
+    /// <summary>
+    /// Gets or sets the maximum tail in seconds rendered after the end of the input, used when the plugin reports an infinite tail. Default is 10 seconds.
+    /// </summary>
+    public double MaxTailSeconds { get; set; } = 10.0;
+}
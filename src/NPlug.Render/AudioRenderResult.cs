@@ -0,0 +1,66 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+namespace NPlug.Render;
+
+/// <summary>
+/// The result of rendering an <see cref="AudioRenderJob"/>.
+/// </summary>
+public sealed class AudioRenderResult
+{
+    internal AudioRenderResult(AudioRenderJob job)
+    {
+        Job = job;
+    }
+
+    /// <summary>
+    /// Gets the associated job.
+    /// </summary>
+    public AudioRenderJob Job { get; }
+
+    /// <summary>
+    /// Gets a boolean indicating whether the rendering was successful.
+    /// </summary>
+    public bool Success => Error is null;
+
+    /// <summary>
+    /// Gets the error message if the rendering failed; <c>null</c> otherwise.
+    /// </summary>
+    public string? Error { get; internal set; }
+
+    /// <summary>
+    /// Gets the sample rate of the input file.
+    /// </summary>
+    public double SampleRate { get; internal set; }
+
+    /// <summary>
+    /// Gets the number of input sample frames processed.
+    /// </summary>
+    public long InputSampleCount { get; internal set; }
+
+    /// <summary>
+    /// Gets the number of sample frames written to the output file (including the tail of the plugin).
+    /// </summary>
+    public long OutputSampleCount { get; internal set; }
+
+    /// <summary>
+    /// Gets the wall clock time spent rendering this job, including the creation of the plugin instance and the reading and writing of the files.
+    /// </summary>
+    public TimeSpan Elapsed { get; internal set; }
+
+    /// <summary>
+    /// Gets the time spent by the plugin processing the audio of this job.
+    /// </summary>
+    public TimeSpan ProcessElapsed { get; internal set; }
+
+    /// <summary>
+    /// Gets the duration of the input audio.
+    /// </summary>
+    public TimeSpan AudioDuration => SampleRate > 0 ? TimeSpan.FromSeconds(InputSampleCount / SampleRate) : TimeSpan.Zero;
+
+    /// <summary>
+    /// Gets the realtime factor of the plugin for this rendering (duration of the audio divided by <see cref="ProcessElapsed"/>).
+    /// </summary>
+    public double RealtimeFactor => ProcessElapsed > TimeSpan.Zero ? AudioDuration.TotalSeconds / ProcessElapsed.TotalSeconds : 0.0;
+}
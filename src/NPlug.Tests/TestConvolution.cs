@@ -0,0 +1,125 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using NPlug.Helpers;
+
+namespace NPlug.Tests;
+
+public class TestConvolution
+{
+    [TestCase(4)]
+    [TestCase(16)]
+    [TestCase(256)]
+    public void TestRealFft(int size)
+    {
+        var random = new Random(size);
+        var input = new float[size];
+        for (int i = 0; i < size; i++)
+        {
+            input[i] = (float)(random.NextDouble() * 2.0 - 1.0);
+        }
+
+        var fft = new RealFft(size);
+        var real = new float[fft.SpectrumLength];
+        var imag = new float[fft.SpectrumLength];
+        fft.Forward(input, real, imag);
+
+        // Compare with a naive DFT
+        for (int k = 0; k < fft.SpectrumLength; k++)
+        {
+            double expectedReal = 0.0;
+            double expectedImag = 0.0;
+            for (int n = 0; n < size; n++)
+            {
+                var angle = -2.0 * Math.PI * k * n / size;
+                expectedReal += input[n] * Math.Cos(angle);
+                expectedImag += input[n] * Math.Sin(angle);
+            }
+            Assert.AreEqual(expectedReal, real[k], 1e-3, $"Invalid real part for bin {k}");
+            Assert.AreEqual(expectedImag, imag[k], 1e-3, $"Invalid imaginary part for bin {k}");
+        }
+
+        var output = new float[size];
+        fft.Inverse(real, imag, output);
+        for (int i = 0; i < size; i++)
+        {
+            Assert.AreEqual(input[i], output[i], 1e-5, $"Invalid sample {i}");
+        }
+    }
+
+    [TestCase(0, 0, false)]
+    [TestCase(0, 0, true)]
+    [TestCase(32, 0, false)]
+    [TestCase(0, 128, false)]
+    [TestCase(16, 128, true)]
+    public void TestConvolver(int latencySamples, int tailPartitionSize, bool inPlace)
+    {
+        var random = new Random(1);
+        var impulseResponse = new float[700];
+        for (int i = 0; i < impulseResponse.Length; i++)
+        {
+            impulseResponse[i] = (float)((random.NextDouble() * 2.0 - 1.0) * Math.Exp(-i / 200.0));
+        }
+        var input = new float[3000];
+        for (int i = 0; i < input.Length; i++)
+        {
+            input[i] = (float)(random.NextDouble() * 2.0 - 1.0);
+        }
+
+        const int maxSamplesPerBlock = 64;
+        var convolver = new AudioConvolver(impulseResponse, latencySamples, tailPartitionSize);
+        convolver.SetupProcessing(maxSamplesPerBlock);
+        Assert.AreEqual((uint)latencySamples, convolver.LatencySamples);
+        Assert.AreEqual((uint)impulseResponse.Length - 1, convolver.TailSamples);
+        Assert.AreEqual(tailPartitionSize, convolver.TailPartitionSize);
+
+        // Process with blocks of varying sizes
+        var output = new float[input.Length];
+        var blockSizes = new[] { 64, 17, 1, 64, 33, 5 };
+        int position = 0;
+        for (int blockIndex = 0; position < input.Length; blockIndex++)
+        {
+            var count = Math.Min(blockSizes[blockIndex % blockSizes.Length], input.Length - position);
+            if (inPlace)
+            {
+                input.AsSpan(position, count).CopyTo(output.AsSpan(position, count));
+                convolver.Process(output.AsSpan(position, count), output.AsSpan(position, count));
+            }
+            else
+            {
+                convolver.Process(input.AsSpan(position, count), output.AsSpan(position, count));
+            }
+            position += count;
+        }
+
+        // Compare with a direct convolution
+        for (int i = 0; i < output.Length; i++)
+        {
+            double expected = 0.0;
+            for (int k = 0; k < impulseResponse.Length; k++)
+            {
+                var inputIndex = i - latencySamples - k;
+                if (inputIndex < 0) break;
+                expected += impulseResponse[k] * input[inputIndex];
+            }
+            Assert.AreEqual(expected, output[i], 1e-3, $"Invalid sample {i}");
+        }
+    }
+
+    [Test]
+    public void TestConvolverReset()
+    {
+        var convolver = new AudioConvolver(new[] { 1.0f, 0.5f, 0.25f });
+        convolver.SetupProcessing(8);
+
+        var output = new float[8];
+        convolver.Process(new[] { 1.0f, 0, 0, 0, 0, 0, 0, 0 }, output);
+        CollectionAssert.AreEqual(new[] { 1.0f, 0.5f, 0.25f, 0, 0, 0, 0, 0 }, output.Select(x => MathF.Round(x, 4)).ToArray());
+
+        convolver.Process(new[] { 0, 0, 0, 0, 0, 0, 0, 1.0f }, output);
+        convolver.Reset();
+        convolver.Process(new float[8], output);
+        Assert.True(AudioHelper.CheckIsSilent(output.AsSpan(), 1e-6f));
+    }
+}
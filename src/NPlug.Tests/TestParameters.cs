@@ -105,10 +105,175 @@ public class TestParameters
         }
     }
 
+    [Test]
+    public void TestSharedSchema()
+    {
+        var model1 = new ProgramModel();
+        model1.Initialize();
+        var factoryCallCount = ProgramModel.FactoryCallCount;
+
+        var model2 = new ProgramModel();
+        model2.Initialize();
+
+        // The program lists are built only once
+        Assert.AreEqual(factoryCallCount, ProgramModel.FactoryCallCount);
+        Assert.AreEqual(2, model2.ParameterCount);
+        Assert.True(model2.ContainsProgramList(model1.GetProgramListByIndex(0).Id));
+        CollectionAssert.AreEqual(new[] { "Quiet", "Loud" }, model2.ProgramChangeParameter!.Items);
+
+        // The program 0 is loaded by default
+        Assert.AreEqual(0.25, model1.Gain.NormalizedValue);
+        Assert.AreEqual(0.25, model2.Gain.NormalizedValue);
+
+        // Values are still per instance
+        model2.SelectedProgramIndex = 1;
+        Assert.AreEqual(0.75, model2.Gain.NormalizedValue);
+        Assert.AreEqual(0.25, model1.Gain.NormalizedValue);
+        Assert.AreSame(model2.Gain, model2.GetParameterById(model2.Gain.Id));
+
+        // Program data is per instance
+        model2.GetProgramListByIndex(0)[1].SetProgramDataFromStream(new MemoryStream(BitConverter.GetBytes(0.5)));
+        model2.SelectedProgramIndex = 1;
+        model1.SelectedProgramIndex = 1;
+        Assert.AreEqual(0.5, model2.Gain.NormalizedValue);
+        Assert.AreEqual(0.75, model1.Gain.NormalizedValue);
+    }
+
+    [Test]
+    public void TestSharedSchemaWithDifferentStructure()
+    {
+        var model1 = new DynamicModel();
+        model1.AddParameter(new AudioParameter("A"));
+        model1.Initialize();
+
+        var model2 = new DynamicModel();
+        model2.AddParameter(new AudioParameter("A"));
+        model2.AddParameter(new AudioParameter("B"));
+        model2.Initialize();
+
+        Assert.AreEqual(1, model1.ParameterCount);
+        Assert.AreEqual(2, model2.ParameterCount);
+        Assert.True(model2.TryGetParameterById(2, out var parameter));
+        Assert.AreEqual("B", parameter!.Title);
+    }
+
+    [Test]
+    public void TestSchemaNotSharedByDefault()
+    {
+        var model1 = new CountingProgramModel();
+        model1.Initialize();
+        var factoryCallCount = CountingProgramModel.FactoryCallCount;
+
+        var model2 = new CountingProgramModel();
+        model2.Initialize();
+
+        Assert.AreEqual(factoryCallCount * 2, CountingProgramModel.FactoryCallCount);
+    }
+
+    [Test]
+    public void TestSharedSchemaWithInstanceFactories()
+    {
+        // Lookups are available before the schema is created
+        var model1 = new GainProgramModel(25);
+        Assert.False(model1.TryGetParameterById(model1.Gain.Id, out _));
+        model1.Initialize();
+
+        // The factories capture the gain of each instance, so the program lists can't be shared
+        var model2 = new GainProgramModel(75);
+        model2.Initialize();
+
+        CollectionAssert.AreEqual(new[] { "Gain 25", "Mute" }, model1.ProgramChangeParameter!.Items);
+        CollectionAssert.AreEqual(new[] { "Gain 75", "Mute" }, model2.ProgramChangeParameter!.Items);
+        Assert.AreEqual(0.25, model1.Gain.NormalizedValue);
+        Assert.AreEqual(0.75, model2.Gain.NormalizedValue);
+        Assert.True(model2.ContainsProgramList(model2.GetProgramListByIndex(0).Id));
+    }
+
     private class SimpleModel : AudioProcessorModel
     {
         public SimpleModel() : base("Simple")
         {
         }
     }
+
+    private class DynamicModel : AudioProcessorModel
+    {
+        public DynamicModel() : base("Dynamic")
+        {
+        }
+
+        protected override bool CanShareSchema => true;
+    }
+
+    private class ProgramModel : AudioProcessorModel
+    {
+        public static int FactoryCallCount;
+
+        public ProgramModel() : base("Programs", new AudioProgramListBuilder<ProgramModel>("Presets")
+        {
+            model =>
+            {
+                FactoryCallCount++;
+                model.Gain.NormalizedValue = 0.25;
+                return new AudioProgram("Quiet");
+            },
+            model =>
+            {
+                FactoryCallCount++;
+                model.Gain.NormalizedValue = 0.75;
+                return new AudioProgram("Loud");
+            },
+        })
+        {
+            Gain = AddParameter(new AudioParameter("Gain", defaultNormalizedValue: 0.5));
+        }
+
+        public AudioParameter Gain { get; }
+
+        protected override bool CanShareSchema => true;
+    }
+
+    private class CountingProgramModel : AudioProcessorModel
+    {
+        public static int FactoryCallCount;
+
+        public CountingProgramModel() : base("Programs", new AudioProgramListBuilder<CountingProgramModel>("Presets")
+        {
+            model =>
+            {
+                FactoryCallCount++;
+                return new AudioProgram("Default");
+            },
+            model =>
+            {
+                FactoryCallCount++;
+                return new AudioProgram("Other");
+            },
+        })
+        {
+            AddParameter(new AudioParameter("Gain"));
+        }
+    }
+
+    private class GainProgramModel : AudioProcessorModel
+    {
+        public GainProgramModel(int gainPercent) : base("Programs", new AudioProgramListBuilder<GainProgramModel>("Presets")
+        {
+            model =>
+            {
+                // Lookups by id are available from a program factory
+                model.GetNormalizedValueById(model.GetParameterById(model.Gain.Id).Id) = gainPercent / 100.0;
+                Assert.True(model.TryGetUnitById(model.Id, out _));
+                return new AudioProgram($"Gain {gainPercent}");
+            },
+            model => new AudioProgram("Mute"),
+        })
+        {
+            Gain = AddParameter(new AudioParameter("Gain", id: 10));
+        }
+
+        public AudioParameter Gain { get; }
+
+        protected override bool CanShareSchema => true;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,289 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using System.Buffers.Binary;
+using NPlug.Render;
+using NPlug.SimpleDelay;
+
+namespace NPlug.Tests;
+
+public class TestRender
+{
+    [Test]
+    public void TestRenderFiles()
+    {
+        var directory = Path.Combine(Path.GetTempPath(), $"NPlug.Tests.Render.{Guid.NewGuid():N}");
+        Directory.CreateDirectory(directory);
+        try
+        {
+            const int sampleRate = 48000;
+            const int frameCount = sampleRate / 2;
+            var jobs = new List<AudioRenderJob>();
+            for (int i = 0; i < 4; i++)
+            {
+                var inputPath = Path.Combine(directory, $"input{i}.wav");
+                WriteSineWave(inputPath, sampleRate, frameCount, 220.0 * (i + 1));
+                jobs.Add(new AudioRenderJob(inputPath, Path.Combine(directory, $"output{i}.wav")));
+            }
+
+            var options = new AudioRenderOptions()
+            {
+                BlockSize = 4096,
+                MaxDegreeOfParallelism = 2,
+            };
+            var results = AudioPluginRenderer.Render(SimpleDelayPlugin.GetFactory(), jobs, options);
+
+            Assert.AreEqual(jobs.Count, results.Length);
+            foreach (var result in results)
+            {
+                Assert.True(result.Success, result.Error);
+                Assert.AreEqual(frameCount, result.InputSampleCount);
+                Assert.GreaterOrEqual(result.OutputSampleCount, result.InputSampleCount);
+                Assert.True(File.Exists(result.Job.OutputPath));
+                Assert.Greater(result.RealtimeFactor, 0.0);
+                Assert.Greater(result.ProcessElapsed, TimeSpan.Zero);
+                Assert.LessOrEqual(result.ProcessElapsed, result.Elapsed);
+            }
+            CollectionAssert.IsEmpty(Directory.EnumerateFiles(directory, "*.tmp.*"));
+        }
+        finally
+        {
+            Directory.Delete(directory, true);
+        }
+    }
+
+    [TestCase(AudioRenderFileFormat.Float32, 1e-6)]
+    [TestCase(AudioRenderFileFormat.Pcm16, 1e-4)]
+    [TestCase(AudioRenderFileFormat.Pcm24, 1e-6)]
+    public unsafe void TestRenderLatencyAndTail(AudioRenderFileFormat format, double tolerance)
+    {
+        var directory = Path.Combine(Path.GetTempPath(), $"NPlug.Tests.Render.{Guid.NewGuid():N}");
+        Directory.CreateDirectory(directory);
+        try
+        {
+            const int sampleRate = 48000;
+            const int frameCount = 12345;
+            var inputPath = Path.Combine(directory, "input.wav");
+            var outputPath = Path.Combine(directory, "output.wav");
+            var input = WriteSineWave(inputPath, sampleRate, frameCount, 440.0);
+
+            var factory = new AudioPluginFactory(new("NPlug", "https://github.com/xoofx/NPlug", "no_reply@nplug.org"));
+            factory.RegisterPlugin<EchoProcessor>(new(EchoProcessor.ClassId, "Echo", AudioProcessorCategory.Effect));
+            var options = new AudioRenderOptions()
+            {
+                // Not a divisor of the length of the file, nor of the latency or tail
+                BlockSize = 1000,
+                OutputFormat = format,
+            };
+            var results = AudioPluginRenderer.Render(factory, new[] { new AudioRenderJob(inputPath, outputPath) }, options);
+            var result = results[0];
+            Assert.True(result.Success, result.Error);
+            Assert.AreEqual(frameCount, result.InputSampleCount);
+            Assert.AreEqual(frameCount + EchoProcessor.Tail, result.OutputSampleCount);
+
+            using (var reader = AudioFileReader.Open(outputPath, options))
+            {
+                Assert.AreEqual(2, reader.ChannelCount);
+                Assert.AreEqual((double)sampleRate, reader.SampleRate);
+
+                var left = new float[result.OutputSampleCount + 1];
+                var right = new float[left.Length];
+                int count;
+                fixed (float* pLeft = left)
+                fixed (float* pRight = right)
+                {
+                    var channels = stackalloc void*[2] { pLeft, pRight };
+                    count = reader.Read(channels, 2, left.Length, AudioSampleSize.Float32);
+                }
+                Assert.AreEqual(result.OutputSampleCount, count);
+
+                // The latency is compensated: the output is aligned with the input, followed by the tail of the echo
+                for (int i = 0; i < count; i++)
+                {
+                    var expected = EchoProcessor.Gain * (i < frameCount ? input[i] : 0.0) + EchoProcessor.EchoGain * (i >= EchoProcessor.Tail ? input[i - EchoProcessor.Tail] : 0.0);
+                    Assert.AreEqual(expected, left[i], tolerance, $"Invalid left sample {i}");
+                    Assert.AreEqual(expected, right[i], tolerance, $"Invalid right sample {i}");
+                }
+            }
+
+            // Check the format of the header
+            var data = File.ReadAllBytes(outputPath);
+            var formatTag = BinaryPrimitives.ReadUInt16LittleEndian(data.AsSpan(20));
+            var bitsPerSample = BinaryPrimitives.ReadUInt16LittleEndian(data.AsSpan(34));
+            switch (format)
+            {
+                case AudioRenderFileFormat.Pcm16:
+                    Assert.AreEqual(1, formatTag);
+                    Assert.AreEqual(16, bitsPerSample);
+                    Assert.True(data.AsSpan(36, 4).SequenceEqual("data"u8));
+                    break;
+                case AudioRenderFileFormat.Pcm24:
+                    Assert.AreEqual(0xFFFE, formatTag);
+                    Assert.AreEqual(24, bitsPerSample);
+                    Assert.AreEqual(1, BinaryPrimitives.ReadUInt16LittleEndian(data.AsSpan(44)), "Invalid sub format");
+                    Assert.True(data.AsSpan(60, 4).SequenceEqual("data"u8));
+                    break;
+                default:
+                    Assert.AreEqual(0xFFFE, formatTag);
+                    Assert.AreEqual(32, bitsPerSample);
+                    Assert.AreEqual(3, BinaryPrimitives.ReadUInt16LittleEndian(data.AsSpan(44)), "Invalid sub format");
+                    Assert.True(data.AsSpan(60, 4).SequenceEqual("fact"u8));
+                    Assert.AreEqual(result.OutputSampleCount, BinaryPrimitives.ReadUInt32LittleEndian(data.AsSpan(68)));
+                    Assert.True(data.AsSpan(72, 4).SequenceEqual("data"u8));
+                    break;
+            }
+            Assert.AreEqual(data.Length - 8, BinaryPrimitives.ReadUInt32LittleEndian(data.AsSpan(4)));
+        }
+        finally
+        {
+            Directory.Delete(directory, true);
+        }
+    }
+
+    [Test]
+    public void TestRenderFailureDoesNotLeavePartialFile()
+    {
+        var directory = Path.Combine(Path.GetTempPath(), $"NPlug.Tests.Render.{Guid.NewGuid():N}");
+        Directory.CreateDirectory(directory);
+        try
+        {
+            var inputPath = Path.Combine(directory, "input.wav");
+            var outputPath = Path.Combine(directory, "output.wav");
+            WriteSineWave(inputPath, 48000, 48000, 440.0);
+
+            // A previous output is kept if the rendering fails
+            File.WriteAllText(outputPath, "previous");
+
+            var factory = new AudioPluginFactory(new("NPlug", "https://github.com/xoofx/NPlug", "no_reply@nplug.org"));
+            factory.RegisterPlugin<FailingProcessor>(new(FailingProcessor.ClassId, "Failing", AudioProcessorCategory.Effect));
+            var results = AudioPluginRenderer.Render(factory, new[] { new AudioRenderJob(inputPath, outputPath) }, new AudioRenderOptions() { BlockSize = 1000 });
+
+            Assert.False(results[0].Success);
+            Assert.AreEqual(FailingProcessor.ErrorMessage, results[0].Error);
+            Assert.AreEqual("previous", File.ReadAllText(outputPath));
+            CollectionAssert.AreEquivalent(new[] { inputPath, outputPath }, Directory.GetFiles(directory));
+        }
+        finally
+        {
+            Directory.Delete(directory, true);
+        }
+    }
+
+    /// <summary>
+    /// Writes a stereo 16-bit sine wave and returns the samples as decoded by the renderer.
+    /// </summary>
+    private static double[] WriteSineWave(string path, int sampleRate, int frameCount, double frequency)
+    {
+        var samples = new double[frameCount];
+        const int channelCount = 2;
+        var data = new byte[44 + frameCount * channelCount * 2];
+        var span = data.AsSpan();
+        "RIFF"u8.CopyTo(span);
+        BinaryPrimitives.WriteInt32LittleEndian(span.Slice(4), data.Length - 8);
+        "WAVEfmt "u8.CopyTo(span.Slice(8));
+        BinaryPrimitives.WriteInt32LittleEndian(span.Slice(16), 16);
+        BinaryPrimitives.WriteInt16LittleEndian(span.Slice(20), 1);
+        BinaryPrimitives.WriteInt16LittleEndian(span.Slice(22), channelCount);
+        BinaryPrimitives.WriteInt32LittleEndian(span.Slice(24), sampleRate);
+        BinaryPrimitives.WriteInt32LittleEndian(span.Slice(28), sampleRate * channelCount * 2);
+        BinaryPrimitives.WriteInt16LittleEndian(span.Slice(32), channelCount * 2);
+        BinaryPrimitives.WriteInt16LittleEndian(span.Slice(34), 16);
+        "data"u8.CopyTo(span.Slice(36));
+        BinaryPrimitives.WriteInt32LittleEndian(span.Slice(40), frameCount * channelCount * 2);
+        for (int i = 0; i < frameCount; i++)
+        {
+            var value = (short)(Math.Sin(2 * Math.PI * frequency * i / sampleRate) * 16384);
+            BinaryPrimitives.WriteInt16LittleEndian(span.Slice(44 + i * 4), value);
+            BinaryPrimitives.WriteInt16LittleEndian(span.Slice(46 + i * 4), value);
+            samples[i] = value / 32768.0;
+        }
+        File.WriteAllBytes(path, data);
+        return samples;
+    }
+
+    /// <summary>
+    /// A processor with a latency that outputs its input with a gain followed by a single echo.
+    /// </summary>
+    private sealed class EchoProcessor : AudioProcessor<EchoModel>
+    {
+        public static readonly Guid ClassId = new("c6a1a4d5-8f0e-4d8b-9a57-2f0d8f1c3b7e");
+        public const int Latency = 64;
+        public const int Tail = 300;
+        public const float Gain = 0.5f;
+        public const float EchoGain = 0.25f;
+
+        private readonly float[][] _history;
+        private int _position;
+
+        public EchoProcessor() : base(AudioSampleSizeSupport.Float32, Latency, Tail, AudioProcessContextRequirementFlags.None)
+        {
+            _history = new[] { new float[Latency + Tail + 1], new float[Latency + Tail + 1] };
+        }
+
+        public override Guid ControllerClassId => Guid.Empty;
+
+        protected override bool Initialize(AudioHostApplication host)
+        {
+            AddAudioInput("AudioInput", SpeakerArrangement.SpeakerStereo);
+            AddAudioOutput("AudioOutput", SpeakerArrangement.SpeakerStereo);
+            return true;
+        }
+
+        protected override void ProcessMain(in AudioProcessData data)
+        {
+            var length = _history[0].Length;
+            var position = _position;
+            for (int channel = 0; channel < 2; channel++)
+            {
+                var input = data.Input[0].GetChannelSpanAsFloat32(ProcessSetupData, data, channel);
+                var output = data.Output[0].GetChannelSpanAsFloat32(ProcessSetupData, data, channel);
+                var history = _history[channel];
+                position = _position;
+                for (int i = 0; i < data.SampleCount; i++)
+                {
+                    history[position] = input[i];
+                    output[i] = Gain * history[(position - Latency + length) % length] + EchoGain * history[(position - Latency - Tail + length) % length];
+                    position = (position + 1) % length;
+                }
+            }
+            _position = position;
+        }
+    }
+
+    /// <summary>
+    /// A processor that fails after having processed a few blocks.
+    /// </summary>
+    private sealed class FailingProcessor : AudioProcessor<EchoModel>
+    {
+        public static readonly Guid ClassId = new("0b8e3f4a-6d2c-4f57-9e21-7c5a3d9b1e60");
+        public const string ErrorMessage = "Processing failed";
+
+        private int _blockCount;
+
+        public FailingProcessor() : base(AudioSampleSizeSupport.Float32)
+        {
+        }
+
+        public override Guid ControllerClassId => Guid.Empty;
+
+        protected override bool Initialize(AudioHostApplication host)
+        {
+            AddAudioInput("AudioInput", SpeakerArrangement.SpeakerStereo);
+            AddAudioOutput("AudioOutput", SpeakerArrangement.SpeakerStereo);
+            return true;
+        }
+
+        protected override void ProcessMain(in AudioProcessData data)
+        {
+            if (++_blockCount == 4) throw new InvalidOperationException(ErrorMessage);
+        }
+    }
+
+    private sealed class EchoModel : AudioProcessorModel
+    {
+        public EchoModel() : base("Echo")
+        {
+        }
+    }
+}
@@ -0,0 +1,153 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using NPlug.Resources;
+
+namespace NPlug.Tests;
+
+public class TestResourceLoader
+{
+    [Test]
+    public void TestPublishAndReclaim()
+    {
+        var loader = new AudioResourceLoader { PollingInterval = TimeSpan.FromMilliseconds(1) };
+        var slot = loader.CreateSlot<int, TestResource>((request, _) => new TestResource(request));
+        Assert.Null(slot.Acquire());
+
+        slot.RequestLoad(1);
+        var first = WaitForResource(slot, 1);
+
+        slot.RequestLoad(2);
+        var second = WaitForResource(slot, 2);
+        Assert.AreSame(second, slot.Current);
+
+        // The first resource is retired by the acquire of the second one and disposed by the loader thread
+        Assert.True(SpinWait.SpinUntil(() => first.IsDisposed, TimeSpan.FromSeconds(5)), "The retired resource was not disposed");
+        Assert.AreNotEqual(Environment.CurrentManagedThreadId, first.DisposedThreadId);
+        Assert.False(second.IsDisposed);
+
+        loader.Dispose();
+        Assert.True(second.IsDisposed);
+        Assert.True(loader.IsDisposed);
+    }
+
+    [Test]
+    public void TestLatestRequestWins()
+    {
+        using var loadStarted = new ManualResetEventSlim(false);
+        using var releaseLoad = new ManualResetEventSlim(false);
+        var loaded = new List<int>();
+        var loader = new AudioResourceLoader { PollingInterval = TimeSpan.FromMilliseconds(1) };
+        var slot = loader.CreateSlot<int, TestResource>((request, _) =>
+        {
+            lock (loaded) loaded.Add(request);
+            loadStarted.Set();
+            releaseLoad.Wait();
+            return new TestResource(request);
+        });
+
+        // Block the loader thread on the first request
+        slot.RequestLoad(1);
+        Assert.True(loadStarted.Wait(TimeSpan.FromSeconds(5)));
+
+        // Requests made while loading are superseded by the last one
+        slot.RequestLoad(2);
+        slot.RequestLoad(3);
+        slot.RequestLoad(4);
+        releaseLoad.Set();
+
+        WaitForResource(slot, 4);
+        lock (loaded) CollectionAssert.AreEqual(new[] { 1, 4 }, loaded);
+        loader.Dispose();
+    }
+
+    [Test]
+    public void TestLoadFailure()
+    {
+        var loader = new AudioResourceLoader { PollingInterval = TimeSpan.FromMilliseconds(1) };
+        var slot = loader.CreateSlot<int, TestResource>((request, _) => request < 0 ? throw new InvalidOperationException("Invalid resource") : new TestResource(request));
+
+        slot.RequestLoad(1);
+        WaitForResource(slot, 1);
+
+        slot.RequestLoad(-1);
+        Assert.True(SpinWait.SpinUntil(() => slot.LastException is not null, TimeSpan.FromSeconds(5)), "The load failure was not reported");
+        Assert.IsInstanceOf<InvalidOperationException>(slot.LastException);
+
+        // The audio thread keeps the previous resource
+        Assert.AreEqual(1, slot.Acquire()!.Value);
+
+        slot.RequestLoad(2);
+        WaitForResource(slot, 2);
+        Assert.Null(slot.LastException);
+        loader.Dispose();
+    }
+
+    [Test]
+    public void TestRequestWakesLoader()
+    {
+        // The loader thread doesn't poll while idle: a request from a non-audio thread wakes it up
+        var loader = new AudioResourceLoader { PollingInterval = TimeSpan.FromHours(1) };
+        var slot = loader.CreateSlot<int, TestResource>((request, _) => new TestResource(request));
+
+        slot.RequestLoad(1);
+        WaitForResource(slot, 1);
+        loader.Dispose();
+
+        Assert.Throws<ObjectDisposedException>(() => slot.RequestLoad(2));
+    }
+
+    [Test]
+    public void TestAudioThreadRequest()
+    {
+        var loader = new AudioResourceLoader { PollingInterval = TimeSpan.FromMilliseconds(1) };
+        var slot = loader.CreateSlot<int, TestResource>((request, _) => new TestResource(request));
+        Assert.Throws<InvalidOperationException>(() => slot.TryRequestLoad(1));
+
+        var audioSlot = loader.CreateSlot<int, TestResource>((request, _) => new TestResource(request), allowAudioThreadRequests: true);
+        Assert.True(audioSlot.TryRequestLoad(1));
+        var first = WaitForResource(audioSlot, 1);
+
+        Assert.True(audioSlot.TryRequestLoad(2));
+        WaitForResource(audioSlot, 2);
+        Assert.True(SpinWait.SpinUntil(() => first.IsDisposed, TimeSpan.FromSeconds(5)), "The retired resource was not disposed");
+
+        loader.Dispose();
+        Assert.False(audioSlot.TryRequestLoad(3));
+    }
+
+    private static TestResource WaitForResource(AudioResourceSlot<int, TestResource> slot, int value)
+    {
+        TestResource? resource = null;
+        // Simulate the audio thread acquiring the resource at the start of each block
+        var found = SpinWait.SpinUntil(() =>
+        {
+            resource = slot.Acquire();
+            return resource?.Value == value;
+        }, TimeSpan.FromSeconds(5));
+        Assert.True(found, $"The resource {value} was not published");
+        return resource!;
+    }
+
+    private sealed class TestResource : IDisposable
+    {
+        private int _disposedThreadId;
+
+        public TestResource(int value)
+        {
+            Value = value;
+        }
+
+        public int Value { get; }
+
+        public int DisposedThreadId => Volatile.Read(ref _disposedThreadId);
+
+        public bool IsDisposed => DisposedThreadId != 0;
+
+        public void Dispose()
+        {
+            Volatile.Write(ref _disposedThreadId, Environment.CurrentManagedThreadId);
+        }
+    }
+}
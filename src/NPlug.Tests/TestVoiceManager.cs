@@ -0,0 +1,177 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using NPlug.Voices;
+
+namespace NPlug.Tests;
+
+public class TestVoiceManager
+{
+    [Test]
+    public void TestNoteOnOff()
+    {
+        var manager = CreateManager(4, AudioVoiceStealingPolicy.Oldest);
+        var renderer = new CountingRenderer();
+
+        Assert.True(manager.TryAddEvent(NoteOn(60, noteId: 1, sampleOffset: 10)));
+        Assert.True(manager.TryAddEvent(NoteOn(64, noteId: 2, sampleOffset: 0)));
+        manager.Process(128, ref renderer);
+
+        Assert.AreEqual(2, manager.Voices.ActiveCount);
+        Assert.AreEqual(2, renderer.StartCount);
+        // Events are sorted by sample offset
+        Assert.AreEqual(2, manager.Voices.NoteId[0]);
+        Assert.AreEqual(1, manager.Voices.NoteId[1]);
+        // The first voice has been rendered on the full block, the second one from its sample offset
+        Assert.AreEqual(128, renderer.RenderedSamples[0]);
+        Assert.AreEqual(118, renderer.RenderedSamples[1]);
+
+        // Release is 0 seconds, the voice is freed at the end of the segment
+        Assert.True(manager.TryAddEvent(NoteOff(64, noteId: 2, sampleOffset: 0)));
+        manager.Process(128, ref renderer);
+        Assert.AreEqual(1, manager.Voices.ActiveCount);
+        Assert.AreEqual(1, manager.Voices.NoteId[0]);
+        Assert.AreEqual(1, renderer.MoveCount);
+    }
+
+    [Test]
+    public void TestStealing()
+    {
+        var manager = CreateManager(2, AudioVoiceStealingPolicy.Oldest);
+        var renderer = new CountingRenderer();
+        manager.TryAddEvent(NoteOn(60, noteId: 1, sampleOffset: 0));
+        manager.TryAddEvent(NoteOn(62, noteId: 2, sampleOffset: 1));
+        manager.TryAddEvent(NoteOn(64, noteId: 3, sampleOffset: 2));
+        manager.Process(64, ref renderer);
+
+        Assert.AreEqual(2, manager.Voices.ActiveCount);
+        CollectionAssert.AreEquivalent(new[] { 2, 3 }, manager.Voices.NoteId.AsSpan(0, 2).ToArray());
+
+        manager.Reset();
+        manager.StealingPolicy = AudioVoiceStealingPolicy.None;
+        manager.TryAddEvent(NoteOn(60, noteId: 1, sampleOffset: 0));
+        manager.TryAddEvent(NoteOn(62, noteId: 2, sampleOffset: 1));
+        manager.TryAddEvent(NoteOn(64, noteId: 3, sampleOffset: 2));
+        manager.Process(64, ref renderer);
+        CollectionAssert.AreEquivalent(new[] { 1, 2 }, manager.Voices.NoteId.AsSpan(0, 2).ToArray());
+    }
+
+    [Test]
+    public void TestStealingOldestAfterManyNotes()
+    {
+        // Start more notes than a float can count exactly (2^24), so that the start orders
+        // of the two last voices can only be distinguished with an integer comparison
+        const int blockSize = 1024;
+        const int noteCount = 1 << 24;
+        var manager = new AudioVoiceManager(2, AudioVoiceStealingPolicy.Oldest, blockSize)
+        {
+            ReleaseSeconds = 0.0f
+        };
+        manager.SetupProcessing(new AudioProcessSetupData(AudioProcessMode.Realtime, AudioSampleSize.Float32, blockSize, 48000.0));
+        var renderer = new CountingRenderer();
+
+        for (int noteId = 1; noteId <= noteCount; noteId++)
+        {
+            manager.TryAddEvent(NoteOn((short)(noteId % 128), noteId, (noteId - 1) % blockSize));
+            if (noteId % blockSize == 0)
+            {
+                manager.Process(blockSize, ref renderer);
+            }
+        }
+
+        // Each new note must steal the oldest voice and keep the previous note
+        for (int noteId = noteCount + 1; noteId <= noteCount + 16; noteId++)
+        {
+            manager.TryAddEvent(NoteOn((short)(noteId % 128), noteId, 0));
+            manager.Process(blockSize, ref renderer);
+            CollectionAssert.AreEquivalent(new[] { noteId - 1, noteId }, manager.Voices.NoteId.AsSpan(0, 2).ToArray(), $"Invalid voices after note {noteId}");
+        }
+    }
+
+    [Test]
+    public void TestEnvelopeAndExpression()
+    {
+        var manager = CreateManager(1, AudioVoiceStealingPolicy.Oldest);
+        manager.AttackSeconds = 0.001f;
+        manager.SustainLevel = 0.5f;
+        manager.DecaySeconds = 0.001f;
+        var renderer = new CountingRenderer();
+
+        manager.TryAddEvent(NoteOn(69, noteId: 7, sampleOffset: 0));
+        var expression = new AudioEvent() { Kind = AudioEventKind.NoteExpressionValue };
+        expression.Value.NoteExpressionValue.NoteId = 7;
+        expression.Value.NoteExpressionValue.TypeId = (uint)AudioNoteExpressionTypeId.Brightness;
+        expression.Value.NoteExpressionValue.Value = 0.75;
+        expression.SampleOffset = 4;
+        manager.TryAddEvent(expression);
+        manager.Process(1024, ref renderer);
+
+        Assert.AreEqual(440.0f, manager.Voices.Frequency[0], 0.01f);
+        Assert.AreEqual(AudioVoiceEnvelopeStage.Sustain, manager.Voices.EnvelopeStage[0]);
+        Assert.AreEqual(0.5f, manager.Voices.EnvelopeLevel[0]);
+        Assert.AreEqual(0.75f, manager.Voices.GetExpressionValues(AudioNoteExpressionTypeId.Brightness)[0]);
+        Assert.AreEqual(0.5f, manager.Voices.GetExpressionValues(AudioNoteExpressionTypeId.Pan)[0]);
+    }
+
+    private static AudioVoiceManager CreateManager(int maxVoices, AudioVoiceStealingPolicy policy)
+    {
+        var manager = new AudioVoiceManager(maxVoices, policy)
+        {
+            ReleaseSeconds = 0.0f
+        };
+        manager.SetupProcessing(new AudioProcessSetupData(AudioProcessMode.Realtime, AudioSampleSize.Float32, 1024, 48000.0));
+        return manager;
+    }
+
+    private static AudioEvent NoteOn(short pitch, int noteId, int sampleOffset)
+    {
+        var evt = new AudioEvent() { Kind = AudioEventKind.NoteOn, SampleOffset = sampleOffset };
+        evt.Value.NoteOn.Pitch = pitch;
+        evt.Value.NoteOn.NoteId = noteId;
+        evt.Value.NoteOn.Velocity = 1.0f;
+        return evt;
+    }
+
+    private static AudioEvent NoteOff(short pitch, int noteId, int sampleOffset)
+    {
+        var evt = new AudioEvent() { Kind = AudioEventKind.NoteOff, SampleOffset = sampleOffset };
+        evt.Value.NoteOff.Pitch = pitch;
+        evt.Value.NoteOff.NoteId = noteId;
+        return evt;
+    }
+
+    private struct CountingRenderer : IAudioVoiceRenderer
+    {
+        public CountingRenderer()
+        {
+            RenderedSamples = new int[16];
+        }
+
+        public int StartCount;
+
+        public int MoveCount;
+
+        public readonly int[] RenderedSamples;
+
+        public void StartVoice(AudioVoiceState voices, int voiceIndex)
+        {
+            StartCount++;
+            RenderedSamples[voiceIndex] = 0;
+        }
+
+        public void MoveVoice(AudioVoiceState voices, int fromIndex, int toIndex)
+        {
+            MoveCount++;
+            RenderedSamples[toIndex] = RenderedSamples[fromIndex];
+        }
+
+        public void RenderVoices(AudioVoiceState voices, int voiceStart, int voiceCount, int sampleOffset, int sampleCount)
+        {
+            for (int i = voiceStart; i < voiceStart + voiceCount; i++)
+            {
+                RenderedSamples[i] += sampleCount;
+            }
+        }
+    }
+}
@@ -0,0 +1,34 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+namespace NPlug;
+
+/// <summary>
+/// A host application used when a plugin is hosted directly from .NET without a native host (e.g for offline rendering).
+/// </summary>
+/// <remarks>
+/// This host does not support messages. <see cref="TryCreateMessage"/> always returns <c>false</c>.
+/// </remarks>
+public sealed class AudioOfflineHostApplication : AudioHostApplication
+{
+    /// <summary>
+    /// Creates a new instance of this host application.
+    /// </summary>
+    /// <param name="name">The name of the host.</param>
+    public AudioOfflineHostApplication(string name) : base(name)
+    {
+    }
+
+    /// <inheritdoc />
+    public override bool TryCreateMessage(string messageId, out AudioMessage message)
+    {
+        message = default;
+        return false;
+    }
+
+    /// <inheritdoc />
+    public override void Dispose()
+    {
+    }
+}
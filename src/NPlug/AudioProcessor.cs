@@ -8,6 +8,7 @@ using System.IO;
 using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 using NPlug.IO;
+using NPlug.Resources;
 
 namespace NPlug;
 
@@ -28,6 +29,7 @@ public abstract partial class AudioProcessor<TAudioProcessorModel>
     private AudioProcessSetupData _processSetupData;
     private PortableBinaryReader? _streamReader;
     private PortableBinaryWriter? _streamWriter;
+    private AudioResourceLoader? _resourceLoader;
 
     /// <summary>
     /// Creates a new instance of this processor.
@@ -90,7 +92,10 @@ public abstract partial class AudioProcessor<TAudioProcessorModel>
     /// <summary>
     /// Gets the latency size in samples.
     /// </summary>
-    public uint LatencySamples { get; }
+    /// <remarks>
+    /// By default, this is the value passed to the constructor. It can be overridden when the latency depends on the processing setup (e.g. an <see cref="NPlug.Helpers.AudioConvolver"/>).
+    /// </remarks>
+    public virtual uint LatencySamples { get; }
 
     /// <summary>
     /// Gets the tail size in samples.
@@ -100,7 +105,10 @@ public abstract partial class AudioProcessor<TAudioProcessorModel>
     /// - x* sampleRate when x Sec tail.
     /// - <see cref="uint.MaxValue"/> when infinite tail.
     /// </summary>
-    public uint TailSamples { get; }
+    /// <remarks>
+    /// By default, this is the value passed to the constructor. It can be overridden when the tail depends on the processing setup (e.g. the impulse response of an <see cref="NPlug.Helpers.AudioConvolver"/>).
+    /// </remarks>
+    public virtual uint TailSamples { get; }
 
     /// <summary>
     /// Gets a boolean indicating whether this processor is active. This value is set when <see cref="IAudioProcessor.SetActive"/> is called.
@@ -112,6 +120,25 @@ public abstract partial class AudioProcessor<TAudioProcessorModel>
     /// </summary>
     protected ref readonly AudioProcessSetupData ProcessSetupData => ref _processSetupData;
 
+    /// <summary>
+    /// Gets the background loader of this processor, used to load heavy resources (samples, impulse responses...) outside of the audio thread.
+    /// </summary>
+    /// <remarks>
+    /// The loader is created before <see cref="Initialize"/> is called and disposed when this processor is terminated. Slots should be created from <see cref="Initialize"/>.
+    /// See <see cref="AudioResourceLoader"/> for more details.
+    /// </remarks>
+    /// <exception cref="InvalidOperationException">If this processor is not initialized.</exception>
+    /// <exception cref="ObjectDisposedException">If this processor is terminated.</exception>
+    protected AudioResourceLoader ResourceLoader
+    {
+        get
+        {
+            var resourceLoader = _resourceLoader ?? throw new InvalidOperationException("The resource loader is only available once the processor is initialized");
+            ObjectDisposedException.ThrowIf(resourceLoader.IsDisposed, resourceLoader);
+            return resourceLoader;
+        }
+    }
+
     /// <summary>
     /// Checks if the specified <see cref="AudioSampleSize"/> is supported by this processor.
     /// </summary>
@@ -190,7 +217,13 @@ public abstract partial class AudioProcessor<TAudioProcessorModel>
 
     internal override bool InitializeInternal(AudioHostApplication hostApplication)
     {
-        return Initialize(hostApplication);
+        // The loader thread is only started when the first slot is created
+        var resourceLoader = new AudioResourceLoader($"NPlug Resource Loader ({GetType().Name})");
+        _resourceLoader = resourceLoader;
+        if (Initialize(hostApplication)) return true;
+
+        resourceLoader.Dispose();
+        return false;
     }
 
     void IAudioProcessor.SetInputOutputMode(InputOutputMode mode)
@@ -255,6 +288,7 @@ public abstract partial class AudioProcessor<TAudioProcessorModel>
         AudioOutputBuses.Clear();
         EventInputBuses.Clear();
         EventOutputBuses.Clear();
+        _resourceLoader?.Dispose();
         base.TerminateInternal();
     }
 }
\ No newline at end of file
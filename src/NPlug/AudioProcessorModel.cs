@@ -19,10 +19,10 @@ namespace NPlug;
 public abstract class AudioProcessorModel : AudioUnit, IDisposable
 {
     private readonly List<AudioUnit> _allUnits;
-    private readonly Dictionary<AudioUnitId, int> _unitIdToIndex;
     private readonly List<AudioParameter> _allParameters;
-    private readonly Dictionary<AudioParameterId, int> _parameterIdToIndex;
     private readonly List<AudioProgramList> _allProgramLists;
+    private readonly Dictionary<AudioUnitId, int> _unitIdToIndex;
+    private readonly Dictionary<AudioParameterId, int> _parameterIdToIndex;
     private readonly Dictionary<AudioProgramListId, int> _programListIdToIndex;
     private nuint _allParameterSizeInBytes;
     private unsafe double* _pointerToBuffer;
@@ -36,13 +36,24 @@ public abstract class AudioProcessorModel : AudioUnit, IDisposable
     protected AudioProcessorModel(string unitName = "Root", AudioProgramListBuilder? programListBuilder = null, int id = 0) : base(unitName, programListBuilder, id)
     {
         _allParameters = new List<AudioParameter>();
-        _parameterIdToIndex = new Dictionary<AudioParameterId, int>();
         _allUnits = new List<AudioUnit>();
-        _unitIdToIndex = new Dictionary<AudioUnitId, int>();
         _allProgramLists = new List<AudioProgramList>();
+        _unitIdToIndex = new Dictionary<AudioUnitId, int>();
+        _parameterIdToIndex = new Dictionary<AudioParameterId, int>();
         _programListIdToIndex = new Dictionary<AudioProgramListId, int>();
     }
 
+    /// <summary>
+    /// Gets a boolean indicating whether the structure of this model can be shared with other instances of the same type. Default is <c>false</c>.
+    /// </summary>
+    /// <remarks>
+    /// When this property returns <c>true</c>, a new instance with the same units, parameter ids, default values and program list factories than the first initialized instance
+    /// reuses its initial values and program data instead of building them again: the program list factories are only called for the first instance.
+    /// Only return <c>true</c> if the programs built by the factories don't depend on the state of the instance (e.g. a constructor argument).
+    /// Program lists built by a derived <see cref="AudioProgramListBuilder"/>, or by factories bound to the model, are never shared.
+    /// </remarks>
+    protected virtual bool CanShareSchema => false;
+
     /// <summary>
     /// Gets the by-pass parameter. This is optional (and only valid for audio effects, not instruments).
     /// </summary>
@@ -134,16 +145,42 @@ public abstract class AudioProcessorModel : AudioUnit, IDisposable
 
         InitializeProgramListParameters();
 
-        InitializeParameters();
+        RegisterParameters();
 
-        // Mark all unit initialized before we initialize the program lists
-        // to make sure that we can't add any parameters or units after this point
-        foreach (var unit in _allUnits)
+        // Reuse the schema of a previous instance of the same type if it has the same structure
+        var canShareSchema = CanShareSchema;
+        var sharedSchema = canShareSchema ? AudioProcessorModelSchema.GetShared(GetType()) : null;
+        if (sharedSchema is not null && sharedSchema.Matches(_allUnits, _allParameters))
         {
-            unit.Initialized = true;
+            InitializeParameterBuffer(sharedSchema.InitialValues);
+            MarkUnitsInitialized();
+            InitializeProgramListsFromSchema(sharedSchema);
+            return;
+        }
+
+        InitializeParameterBuffer(ReadOnlySpan<double>.Empty);
+
+        // The values before the program lists are built are only needed to match a schema
+        double[]? registeredValues = null;
+        if (canShareSchema)
+        {
+            registeredValues = new double[_allParameters.Count];
+            for (int i = 0; i < registeredValues.Length; i++)
+            {
+                registeredValues[i] = _allParameters[i].NormalizedValue;
+            }
         }
 
+        // Mark all unit initialized before we initialize the program lists
+        // to make sure that we can't add any parameters or units after this point
+        MarkUnitsInitialized();
+
         InitializeProgramLists();
+
+        if (registeredValues is not null)
+        {
+            AudioProcessorModelSchema.TryAddShared(GetType(), _allUnits, _allParameters, registeredValues, _allProgramLists);
+        }
     }
 
     /// <summary>
@@ -401,8 +438,8 @@ public abstract class AudioProcessorModel : AudioUnit, IDisposable
         _parameterIdToIndex[parameter.Id] = _allParameters.Count;
         _allParameters.Add(parameter);
     }
-   
-    private unsafe void InitializeParameters()
+
+    private void RegisterParameters()
     {
         // Register all parameters from all units
         foreach (var unit in _allUnits)
@@ -414,7 +451,10 @@ public abstract class AudioProcessorModel : AudioUnit, IDisposable
                 RegisterParameter(parameter);
             }
         }
+    }
 
+    private unsafe void InitializeParameterBuffer(ReadOnlySpan<double> initialValues)
+    {
         // Allocate the memory for all parameters (double size)
         var allParameterSizeInBytes = _allParameters.Count * sizeof(double);
         var memoryToAllocate = MathHelper.AlignToUpper((nuint)allParameterSizeInBytes, AlignedSize);
@@ -429,11 +469,41 @@ public abstract class AudioProcessorModel : AudioUnit, IDisposable
         {
             var audioParameter = _allParameters[i];
             audioParameter.PointerToNormalizedValueInSharedBuffer = pValue;
-            *pValue = audioParameter.NormalizedValue;
+            *pValue = initialValues.IsEmpty ? audioParameter.NormalizedValueInternal : initialValues[i];
             pValue++;
         }
     }
 
+    private void MarkUnitsInitialized()
+    {
+        foreach (var unit in _allUnits)
+        {
+            unit.Initialized = true;
+        }
+    }
+
+    private void InitializeProgramListsFromSchema(AudioProcessorModelSchema schema)
+    {
+        var programLists = new AudioProgramList?[schema.ProgramListCount];
+        for (var i = 0; i < _allUnits.Count; i++)
+        {
+            var unit = _allUnits[i];
+            var programList = schema.CreateProgramList(i, programLists);
+            if (programList is null) continue;
+
+            unit.ProgramList = programList;
+            if (unit.ProgramChangeParameter is { } presetParameter)
+            {
+                presetParameter.Items = schema.GetProgramNames(Array.IndexOf(programLists, programList));
+            }
+        }
+
+        foreach (var programList in programLists)
+        {
+            RegisterProgramList(programList!);
+        }
+    }
+
     private void InitializeProgramLists()
     {
         // Mark all unit initialized
@@ -0,0 +1,218 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.CompilerServices;
+
+namespace NPlug;
+
+/// <summary>
+/// The immutable structure of an initialized <see cref="AudioProcessorModel"/>: ids of units and parameters, initial parameter values and program data.
+/// </summary>
+/// <remarks>
+/// A schema is only built for a model type that opts in with <see cref="AudioProcessorModel.CanShareSchema"/>, by the first instance that is initialized,
+/// and then shared by the instances of the same type that have the same units, parameters and program list builders.
+/// Instances sharing a schema don't run the program list factories again.
+/// Each instance still creates its own units, parameters, program lists, programs and id lookup tables: only the initial values and the program data buffers are shared.
+/// The schemas are attached to the model type, so they don't prevent a collectible assembly load context from being unloaded.
+/// </remarks>
+internal sealed class AudioProcessorModelSchema
+{
+    private static readonly ConditionalWeakTable<Type, AudioProcessorModelSchema> SharedSchemas = new();
+
+    private readonly AudioUnitId[] _unitIds;
+    private readonly AudioParameterId[] _parameterIds;
+    private readonly double[] _registeredValues;
+    private readonly double[] _initialValues;
+    private readonly int[] _unitToProgramListIndex;
+    private readonly ProgramListBuilderSnapshot?[] _unitBuilders;
+    private readonly ProgramListSnapshot[] _programLists;
+
+    private AudioProcessorModelSchema(AudioUnitId[] unitIds, AudioParameterId[] parameterIds, double[] registeredValues, double[] initialValues, int[] unitToProgramListIndex, ProgramListBuilderSnapshot?[] unitBuilders, ProgramListSnapshot[] programLists)
+    {
+        _unitIds = unitIds;
+        _parameterIds = parameterIds;
+        _registeredValues = registeredValues;
+        _initialValues = initialValues;
+        _unitToProgramListIndex = unitToProgramListIndex;
+        _unitBuilders = unitBuilders;
+        _programLists = programLists;
+    }
+
+    /// <summary>
+    /// Gets the number of program lists.
+    /// </summary>
+    public int ProgramListCount => _programLists.Length;
+
+    /// <summary>
+    /// Gets the normalized values of the parameters of a model right after its initialization.
+    /// </summary>
+    internal ReadOnlySpan<double> InitialValues => _initialValues;
+
+    internal static AudioProcessorModelSchema? GetShared(Type modelType) => SharedSchemas.TryGetValue(modelType, out var schema) ? schema : null;
+
+    /// <summary>
+    /// Creates a schema from an initialized model and shares it with the next instances of the model type, if its program lists can be shared.
+    /// </summary>
+    internal static void TryAddShared(Type modelType, List<AudioUnit> units, List<AudioParameter> parameters, double[] registeredValues, List<AudioProgramList> programLists)
+    {
+        if (SharedSchemas.TryGetValue(modelType, out _) || !CanShare(units, programLists)) return;
+
+        SharedSchemas.TryAdd(modelType, Create(units, parameters, registeredValues, programLists));
+    }
+
+    /// <summary>
+    /// Checks that the registered units, parameters and program list builders of a model are the same than the ones described by this schema.
+    /// </summary>
+    internal bool Matches(List<AudioUnit> units, List<AudioParameter> parameters)
+    {
+        if (units.Count != _unitIds.Length || parameters.Count != _parameterIds.Length) return false;
+
+        for (int i = 0; i < units.Count; i++)
+        {
+            var unit = units[i];
+            if (unit.Id != _unitIds[i]) return false;
+
+            // The programs are only the same if they are built by the same factories
+            var builder = unit.ProgramListBuilder;
+            var builderSnapshot = _unitBuilders[i];
+            if (builder is null ? builderSnapshot is not null : builderSnapshot is null || !builderSnapshot.Matches(builder)) return false;
+        }
+
+        for (int i = 0; i < parameters.Count; i++)
+        {
+            var parameter = parameters[i];
+            if (parameter.Id != _parameterIds[i] || parameter.NormalizedValue != _registeredValues[i]) return false;
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Creates the program list of the specified unit from this schema.
+    /// </summary>
+    internal AudioProgramList? CreateProgramList(int unitIndex, AudioProgramList?[] programLists)
+    {
+        var programListIndex = _unitToProgramListIndex[unitIndex];
+        if (programListIndex < 0) return null;
+
+        // A program list can be shared by multiple units
+        var programList = programLists[programListIndex];
+        if (programList is not null) return programList;
+
+        var snapshot = _programLists[programListIndex];
+        programList = new AudioProgramList(snapshot.Name, snapshot.Id.Value, snapshot.Programs.Length);
+        foreach (var programSnapshot in snapshot.Programs)
+        {
+            var program = new AudioProgram(programSnapshot.Name);
+            foreach (var pair in programSnapshot.PitchNames)
+            {
+                program.PitchNames.Add(pair.Key, pair.Value);
+            }
+            foreach (var pair in programSnapshot.Attributes)
+            {
+                program.Attributes.Add(pair.Key, pair.Value);
+            }
+            if (programSnapshot.Data is not null)
+            {
+                program.SetProgramDataFromSharedBuffer(programSnapshot.Data);
+            }
+            programList.Add(program);
+        }
+        programList.Initialized = true;
+        programLists[programListIndex] = programList;
+        return programList;
+    }
+
+    internal string[] GetProgramNames(int programListIndex) => _programLists[programListIndex].ProgramNames;
+
+    private static bool CanShare(List<AudioUnit> units, List<AudioProgramList> programLists)
+    {
+        foreach (var programList in programLists)
+        {
+            for (int i = 0; i < programList.Count; i++)
+            {
+                // A derived program could hold additional data that we can't replicate
+                if (programList[i].GetType() != typeof(AudioProgram)) return false;
+            }
+        }
+
+        foreach (var unit in units)
+        {
+            if (unit.ProgramListBuilder is { } builder)
+            {
+                // A factory bound to the model (e.g. an instance method) is different for each instance and would keep this instance alive
+                var factories = builder.GetProgramFactories();
+                if (factories is null || factories.Any(factory => factory.Target is AudioUnit)) return false;
+            }
+        }
+
+        return true;
+    }
+
+    private static AudioProcessorModelSchema Create(List<AudioUnit> units, List<AudioParameter> parameters, double[] registeredValues, List<AudioProgramList> programLists)
+    {
+        var unitIds = new AudioUnitId[units.Count];
+        for (int i = 0; i < units.Count; i++)
+        {
+            unitIds[i] = units[i].Id;
+        }
+
+        var parameterIds = new AudioParameterId[parameters.Count];
+        var initialValues = new double[parameters.Count];
+        for (int i = 0; i < parameters.Count; i++)
+        {
+            parameterIds[i] = parameters[i].Id;
+            initialValues[i] = parameters[i].NormalizedValue;
+        }
+
+        var programListSnapshots = new ProgramListSnapshot[programLists.Count];
+        for (int i = 0; i < programLists.Count; i++)
+        {
+            var programList = programLists[i];
+            var programs = new ProgramSnapshot[programList.Count];
+            var programNames = new string[programList.Count];
+            for (int j = 0; j < programList.Count; j++)
+            {
+                var program = programList[j];
+                programs[j] = new ProgramSnapshot(program.Name, program.GetProgramDataAsBytes(), program.PitchNames.ToArray(), program.Attributes.ToArray());
+                programNames[j] = program.Name;
+            }
+            programListSnapshots[i] = new ProgramListSnapshot(programList.Name, programList.Id, programs, programNames);
+        }
+
+        var unitToProgramListIndex = new int[units.Count];
+        var unitBuilders = new ProgramListBuilderSnapshot?[units.Count];
+        for (int i = 0; i < units.Count; i++)
+        {
+            var unit = units[i];
+            var programList = unit.ProgramList;
+            unitToProgramListIndex[i] = programList is null ? -1 : programLists.IndexOf(programList);
+
+            if (unit.ProgramListBuilder is { } builder)
+            {
+                unitBuilders[i] = new ProgramListBuilderSnapshot(builder.GetType(), builder.Name, builder.Id, builder.GetProgramFactories()!);
+            }
+        }
+
+        return new AudioProcessorModelSchema(unitIds, parameterIds, registeredValues, initialValues, unitToProgramListIndex, unitBuilders, programListSnapshots);
+    }
+
+    private sealed record ProgramListBuilderSnapshot(Type BuilderType, string Name, AudioProgramListId Id, Delegate[] Factories)
+    {
+        public bool Matches(AudioProgramListBuilder builder)
+        {
+            if (builder.GetType() != BuilderType || builder.Name != Name || builder.Id != Id) return false;
+
+            var factories = builder.GetProgramFactories();
+            return factories is not null && factories.SequenceEqual(Factories);
+        }
+    }
+
+    private sealed record ProgramListSnapshot(string Name, AudioProgramListId Id, ProgramSnapshot[] Programs, string[] ProgramNames);
+
+    private sealed record ProgramSnapshot(string Name, byte[]? Data, KeyValuePair<short, string>[] PitchNames, KeyValuePair<string, string>[] Attributes);
+}
@@ -93,4 +93,24 @@ public class AudioProgram
         memoryStream.Position = 0;
         _originalPosition = 0;
     }
+
+    /// <summary>
+    /// Sets the program data from a buffer shared between instances. The buffer is not copied and must not be modified.
+    /// </summary>
+    internal void SetProgramDataFromSharedBuffer(byte[] buffer)
+    {
+        _stream = new MemoryStream(buffer, false);
+        _originalPosition = 0;
+    }
+
+    internal byte[]? GetProgramDataAsBytes()
+    {
+        var stream = GetProgramData();
+        if (stream is null) return null;
+
+        var memoryStream = new MemoryStream();
+        stream.CopyTo(memoryStream);
+        stream.Position = _originalPosition;
+        return memoryStream.ToArray();
+    }
 }
\ No newline at end of file
@@ -67,6 +67,11 @@ public abstract class AudioProgramListBuilder
         return new AudioStringListParameter(ProgramChangeParameterName, TempItems, id: ProgramChangeParameterId.Value, flags: (ProgramChangeCanAutomate ? AudioParameterFlags.CanAutomate : AudioParameterFlags.NoFlags) | AudioParameterFlags.IsList | AudioParameterFlags.IsProgramChange);
     }
 
+    /// <summary>
+    /// Gets the program factories of this builder, used to check that the builders of two model instances build the same programs. Returns null if this builder can't be compared.
+    /// </summary>
+    internal virtual Delegate[]? GetProgramFactories() => null;
+
     private static readonly string[] TempItems = new [] { string.Empty, string.Empty };
 }
 
@@ -140,6 +145,12 @@ public class AudioProgramListBuilder<TAudioProcessorModel>
         return programList;
     }
 
+    /// <inheritdoc />
+    internal override Delegate[]? GetProgramFactories()
+    {
+        // A derived builder can build its programs differently
+        return GetType() == typeof(AudioProgramListBuilder<TAudioProcessorModel>) ? _dataFactories.ToArray() : null;
+    }
 
     IEnumerator<Func<TAudioProcessorModel, AudioProgram>> IEnumerable<Func<TAudioProcessorModel, AudioProgram>>.GetEnumerator()
     {
@@ -0,0 +1,220 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using System;
+using System.Numerics;
+using System.Runtime.InteropServices;
+
+namespace NPlug.Helpers;
+
+/// <summary>
+/// Uniformly partitioned overlap-save convolution of a segment of an impulse response.
+/// </summary>
+/// <remarks>
+/// The impulse response is split in partitions of <see cref="PartitionSize"/> samples, each transformed with a FFT of 2 * <see cref="PartitionSize"/>.
+/// The spectra of the last input windows are kept in a frequency-domain delay line.
+/// - In zero latency mode, a forward and an inverse FFT of the current (partial) window are computed for each call, whatever its number of samples.
+/// - Otherwise, the convolution is computed once per partition and the output is delayed by <see cref="PartitionSize"/> samples.
+/// In both modes, the contribution of the previous windows is accumulated progressively while the samples of a partition are received,
+/// so that the cost of a long impulse response is spread over the blocks of a partition instead of being paid by the block that completes it.
+/// </remarks>
+internal sealed class AudioConvolutionStage
+{
+    private readonly RealFft _fft;
+    private readonly bool _zeroLatency;
+    private readonly int _spectrumStride;
+    private readonly float[] _impulseReal;
+    private readonly float[] _impulseImag;
+    private readonly float[] _delayLineReal;
+    private readonly float[] _delayLineImag;
+    private readonly float[] _accumulatorReal;
+    private readonly float[] _accumulatorImag;
+    private readonly float[] _nextAccumulatorReal;
+    private readonly float[] _nextAccumulatorImag;
+    private readonly float[] _sumReal;
+    private readonly float[] _sumImag;
+    private readonly float[] _window;
+    private readonly float[] _output;
+    private int _position;
+    private int _currentPartition;
+    private int _nextPartition;
+
+    public AudioConvolutionStage(ReadOnlySpan<float> impulseResponse, int partitionSize, bool zeroLatency)
+    {
+        PartitionSize = partitionSize;
+        PartitionCount = Math.Max(1, (impulseResponse.Length + partitionSize - 1) / partitionSize);
+        _zeroLatency = zeroLatency;
+        _fft = new RealFft(2 * partitionSize);
+
+        // Pad the spectra to a multiple of the vector size to accumulate them with full vectors only
+        var vectorSize = Vector<float>.Count;
+        _spectrumStride = (_fft.SpectrumLength + vectorSize - 1) / vectorSize * vectorSize;
+
+        _impulseReal = new float[PartitionCount * _spectrumStride];
+        _impulseImag = new float[PartitionCount * _spectrumStride];
+        for (int i = 0; i < PartitionCount; i++)
+        {
+            var start = i * partitionSize;
+            var length = Math.Max(0, Math.Min(partitionSize, impulseResponse.Length - start));
+            _fft.Forward(length > 0 ? impulseResponse.Slice(start, length) : ReadOnlySpan<float>.Empty, GetSpectrum(_impulseReal, i), GetSpectrum(_impulseImag, i));
+        }
+
+        _delayLineReal = new float[PartitionCount * _spectrumStride];
+        _delayLineImag = new float[PartitionCount * _spectrumStride];
+        _accumulatorReal = new float[_spectrumStride];
+        _accumulatorImag = new float[_spectrumStride];
+        _nextAccumulatorReal = new float[_spectrumStride];
+        _nextAccumulatorImag = new float[_spectrumStride];
+        _sumReal = new float[_spectrumStride];
+        _sumImag = new float[_spectrumStride];
+        _window = new float[2 * partitionSize];
+        _output = new float[2 * partitionSize];
+        _nextPartition = FirstProgressivePartition;
+    }
+
+    public int PartitionSize { get; }
+
+    public int PartitionCount { get; }
+
+    public uint LatencySamples => _zeroLatency ? 0 : (uint)PartitionSize;
+
+    /// <summary>
+    /// Gets the first partition of the impulse response that is accumulated progressively. In zero latency mode,
+    /// the partition 1 is applied to the window that is only complete at the end of the current partition.
+    /// </summary>
+    private int FirstProgressivePartition => _zeroLatency ? 2 : 1;
+
+    /// <summary>
+    /// Convolves the input to the output. Input and output can be the same buffer.
+    /// </summary>
+    public void Process(ReadOnlySpan<float> input, Span<float> output)
+    {
+        var partitionSize = PartitionSize;
+        int processed = 0;
+        while (processed < input.Length)
+        {
+            var count = Math.Min(input.Length - processed, partitionSize - _position);
+            var inputChunk = input.Slice(processed, count);
+            var outputChunk = output.Slice(processed, count);
+            var windowChunk = _window.AsSpan(partitionSize + _position, count);
+            inputChunk.CopyTo(windowChunk);
+
+            if (_zeroLatency)
+            {
+                // The samples of the window after the current position are still zero,
+                // so the output is exact up to the current position
+                var currentReal = GetSpectrum(_delayLineReal, _currentPartition);
+                var currentImag = GetSpectrum(_delayLineImag, _currentPartition);
+                _fft.Forward(_window, currentReal, currentImag);
+                _accumulatorReal.AsSpan().CopyTo(_sumReal);
+                _accumulatorImag.AsSpan().CopyTo(_sumImag);
+                MultiplyAccumulate(currentReal, currentImag, GetSpectrum(_impulseReal, 0), GetSpectrum(_impulseImag, 0), _sumReal, _sumImag);
+                _fft.Inverse(_sumReal, _sumImag, _output);
+                _output.AsSpan(partitionSize + _position, count).CopyTo(outputChunk);
+                _position += count;
+
+                // Accumulate the previous windows for the next partition
+                AccumulatePreviousPartitions(_currentPartition + 1 == PartitionCount ? 0 : _currentPartition + 1, _nextAccumulatorReal, _nextAccumulatorImag);
+
+                if (_position == partitionSize)
+                {
+                    // The current window is now complete and becomes the previous window of the next partition
+                    if (PartitionCount > 1)
+                    {
+                        MultiplyAccumulate(currentReal, currentImag, GetSpectrum(_impulseReal, 1), GetSpectrum(_impulseImag, 1), _nextAccumulatorReal, _nextAccumulatorImag);
+                    }
+                    _nextAccumulatorReal.AsSpan().CopyTo(_accumulatorReal);
+                    _nextAccumulatorImag.AsSpan().CopyTo(_accumulatorImag);
+                    _nextAccumulatorReal.AsSpan().Clear();
+                    _nextAccumulatorImag.AsSpan().Clear();
+                    _nextPartition = FirstProgressivePartition;
+                }
+            }
+            else
+            {
+                // Output the result of the previous partition, delayed by the partition size
+                _output.AsSpan(partitionSize + _position, count).CopyTo(outputChunk);
+                _position += count;
+
+                AccumulatePreviousPartitions(_currentPartition, _accumulatorReal, _accumulatorImag);
+
+                if (_position == partitionSize)
+                {
+                    _fft.Forward(_window, GetSpectrum(_delayLineReal, _currentPartition), GetSpectrum(_delayLineImag, _currentPartition));
+                    MultiplyAccumulate(GetSpectrum(_delayLineReal, _currentPartition), GetSpectrum(_delayLineImag, _currentPartition), GetSpectrum(_impulseReal, 0), GetSpectrum(_impulseImag, 0), _accumulatorReal, _accumulatorImag);
+                    _fft.Inverse(_accumulatorReal, _accumulatorImag, _output);
+                    _accumulatorReal.AsSpan().Clear();
+                    _accumulatorImag.AsSpan().Clear();
+                    _nextPartition = FirstProgressivePartition;
+                }
+            }
+
+            if (_position == partitionSize)
+            {
+                // Slide the window for the next partition
+                _window.AsSpan(partitionSize, partitionSize).CopyTo(_window);
+                _window.AsSpan(partitionSize, partitionSize).Clear();
+                _position = 0;
+                _currentPartition = _currentPartition + 1 == PartitionCount ? 0 : _currentPartition + 1;
+            }
+
+            processed += count;
+        }
+    }
+
+    public void Reset()
+    {
+        _delayLineReal.AsSpan().Clear();
+        _delayLineImag.AsSpan().Clear();
+        _accumulatorReal.AsSpan().Clear();
+        _accumulatorImag.AsSpan().Clear();
+        _nextAccumulatorReal.AsSpan().Clear();
+        _nextAccumulatorImag.AsSpan().Clear();
+        _window.AsSpan().Clear();
+        _output.AsSpan().Clear();
+        _position = 0;
+        _currentPartition = 0;
+        _nextPartition = FirstProgressivePartition;
+    }
+
+    /// <summary>
+    /// Accumulates the share of the previous windows matching the number of samples received in the current partition,
+    /// so that all the partitions are accumulated when the current partition is complete.
+    /// </summary>
+    /// <param name="windowPartition">The slot in the delay line of the window the accumulated partitions are applied to.</param>
+    private void AccumulatePreviousPartitions(int windowPartition, Span<float> accumulatorReal, Span<float> accumulatorImag)
+    {
+        var firstPartition = FirstProgressivePartition;
+        var targetPartition = firstPartition + (PartitionCount - firstPartition) * _position / PartitionSize;
+
+        // Partition i of the impulse response is applied to the input window received i partitions before the window
+        for (; _nextPartition < targetPartition; _nextPartition++)
+        {
+            var delayIndex = windowPartition - _nextPartition;
+            if (delayIndex < 0) delayIndex += PartitionCount;
+            MultiplyAccumulate(GetSpectrum(_delayLineReal, delayIndex), GetSpectrum(_delayLineImag, delayIndex), GetSpectrum(_impulseReal, _nextPartition), GetSpectrum(_impulseImag, _nextPartition), accumulatorReal, accumulatorImag);
+        }
+    }
+
+    private Span<float> GetSpectrum(float[] spectra, int index) => spectra.AsSpan(index * _spectrumStride, _spectrumStride);
+
+    private static void MultiplyAccumulate(ReadOnlySpan<float> xReal, ReadOnlySpan<float> xImag, ReadOnlySpan<float> hReal, ReadOnlySpan<float> hImag, Span<float> accumulatorReal, Span<float> accumulatorImag)
+    {
+        var xr = MemoryMarshal.Cast<float, Vector<float>>(xReal);
+        var xi = MemoryMarshal.Cast<float, Vector<float>>(xImag);
+        var hr = MemoryMarshal.Cast<float, Vector<float>>(hReal);
+        var hi = MemoryMarshal.Cast<float, Vector<float>>(hImag);
+        var ar = MemoryMarshal.Cast<float, Vector<float>>(accumulatorReal);
+        var ai = MemoryMarshal.Cast<float, Vector<float>>(accumulatorImag);
+        for (int i = 0; i < ar.Length; i++)
+        {
+            var a = xr[i];
+            var b = xi[i];
+            var c = hr[i];
+            var d = hi[i];
+            ar[i] += a * c - b * d;
+            ai[i] += a * d + b * c;
+        }
+    }
+}
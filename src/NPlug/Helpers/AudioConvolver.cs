@@ -0,0 +1,171 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using System;
+using System.Numerics;
+
+namespace NPlug.Helpers;
+
+/// <summary>
+/// A partitioned overlap-save convolution engine for a single channel, suitable for long impulse responses (reverbs, cabinets, linear-phase filters...).
+/// </summary>
+/// <remarks>
+/// The impulse response is processed by a head stage using partitions of the size of a block (or of <see cref="LatencySamples"/>).
+/// When a tail partition size is specified, the rest of the impulse response is processed by a tail stage with larger partitions, which reduces the cost for long impulse responses.
+/// The contribution of the previous partitions of each stage is accumulated progressively over the blocks, but the tail stage still computes
+/// the FFTs of a full partition in the block that completes it, once every tail partition size samples.
+/// In zero latency mode (the default), each call to <see cref="Process"/> runs a forward and an inverse FFT of 2 * <see cref="HeadPartitionSize"/> samples
+/// for the head stage, whatever the number of samples processed: the cost of a call doesn't shrink with the block size, so many small blocks are expensive.
+/// A latency greater than 0 runs these FFTs once every <see cref="LatencySamples"/> samples instead.
+/// All the buffers are allocated by <see cref="SetupProcessing(int)"/>: <see cref="Process"/> doesn't allocate.
+/// Use one instance per channel.
+/// </remarks>
+public sealed class AudioConvolver
+{
+    private readonly float[] _impulseResponse;
+    private readonly int _latencySamples;
+    private readonly int _tailPartitionSize;
+    private AudioConvolutionStage? _head;
+    private AudioConvolutionStage? _tail;
+    private float[] _tailOutput;
+
+    /// <summary>
+    /// Creates a new instance of this convolver.
+    /// </summary>
+    /// <param name="impulseResponse">The impulse response. The samples are copied.</param>
+    /// <param name="latencySamples">The latency in samples. 0 for zero latency, otherwise a power of 2 used as the partition size of the head stage.</param>
+    /// <param name="tailPartitionSize">The partition size of the tail stage, a power of 2. 0 to use uniform partitions for the whole impulse response. Ignored if it is not greater than the partition size of the head stage.</param>
+    public AudioConvolver(ReadOnlySpan<float> impulseResponse, int latencySamples = 0, int tailPartitionSize = 0)
+    {
+        if (latencySamples < 0 || (latencySamples > 0 && (latencySamples < 2 || !BitOperations.IsPow2(latencySamples)))) throw new ArgumentOutOfRangeException(nameof(latencySamples), latencySamples, "The latency must be 0 or a power of 2 greater or equal to 2");
+        if (tailPartitionSize < 0 || (tailPartitionSize > 0 && (tailPartitionSize < 2 || !BitOperations.IsPow2(tailPartitionSize)))) throw new ArgumentOutOfRangeException(nameof(tailPartitionSize), tailPartitionSize, "The tail partition size must be 0 or a power of 2 greater or equal to 2");
+
+        _impulseResponse = impulseResponse.ToArray();
+        _latencySamples = latencySamples;
+        _tailPartitionSize = tailPartitionSize;
+        _tailOutput = Array.Empty<float>();
+    }
+
+    /// <summary>
+    /// Gets the length of the impulse response.
+    /// </summary>
+    public int ImpulseResponseLength => _impulseResponse.Length;
+
+    /// <summary>
+    /// Gets the latency in samples introduced by this convolver.
+    /// </summary>
+    /// <remarks>
+    /// A processor using this convolver should report this value with <see cref="AudioProcessor{TAudioProcessorModel}.LatencySamples"/>.
+    /// </remarks>
+    public uint LatencySamples => (uint)_latencySamples;
+
+    /// <summary>
+    /// Gets the tail in samples produced by this convolver once the input is silent.
+    /// </summary>
+    /// <remarks>
+    /// A processor using this convolver should report this value with <see cref="AudioProcessor{TAudioProcessorModel}.TailSamples"/>.
+    /// </remarks>
+    public uint TailSamples => (uint)Math.Max(0, _impulseResponse.Length - 1);
+
+    /// <summary>
+    /// Gets the partition size of the head stage. This value is available after <see cref="SetupProcessing(int)"/> is called.
+    /// </summary>
+    public int HeadPartitionSize => _head?.PartitionSize ?? 0;
+
+    /// <summary>
+    /// Gets the partition size of the tail stage, or 0 if there is no tail stage. This value is available after <see cref="SetupProcessing(int)"/> is called.
+    /// </summary>
+    public int TailPartitionSize => _tail?.PartitionSize ?? 0;
+
+    /// <summary>
+    /// Gets a boolean indicating whether <see cref="SetupProcessing(int)"/> has been called.
+    /// </summary>
+    public bool IsSetup => _head is not null;
+
+    /// <summary>
+    /// Allocates the buffers of this convolver for the specified process setup and resets its state. This method must be called from <c>OnSetupProcessing</c>.
+    /// </summary>
+    /// <param name="processSetupData">The process setup data.</param>
+    public void SetupProcessing(in AudioProcessSetupData processSetupData) => SetupProcessing(processSetupData.MaxSamplesPerBlock);
+
+    /// <summary>
+    /// Allocates the buffers of this convolver for the specified maximum number of samples per block and resets its state.
+    /// </summary>
+    /// <param name="maxSamplesPerBlock">The maximum number of samples per block.</param>
+    public void SetupProcessing(int maxSamplesPerBlock)
+    {
+        if (maxSamplesPerBlock <= 0) throw new ArgumentOutOfRangeException(nameof(maxSamplesPerBlock), maxSamplesPerBlock, "The maximum number of samples per block must be > 0");
+
+        // In zero latency mode, the head stage computes a FFT per block, so a partition that covers a full block minimizes the number of FFTs
+        var headPartitionSize = _latencySamples > 0 ? _latencySamples : Math.Max(2, (int)BitOperations.RoundUpToPowerOf2((uint)maxSamplesPerBlock));
+        var impulseResponse = _impulseResponse.AsSpan();
+
+        if (_tailPartitionSize > headPartitionSize)
+        {
+            // The tail stage has a latency of its partition size, so it starts at this offset in the impulse response
+            // (minus the latency already introduced by the head stage)
+            var tailOffset = _tailPartitionSize - _latencySamples;
+            if (impulseResponse.Length > tailOffset)
+            {
+                _head = new AudioConvolutionStage(impulseResponse.Slice(0, tailOffset), headPartitionSize, _latencySamples == 0);
+                _tail = new AudioConvolutionStage(impulseResponse.Slice(tailOffset), _tailPartitionSize, false);
+                _tailOutput = new float[maxSamplesPerBlock];
+                return;
+            }
+        }
+
+        _head = new AudioConvolutionStage(impulseResponse, headPartitionSize, _latencySamples == 0);
+        _tail = null;
+        _tailOutput = Array.Empty<float>();
+    }
+
+    /// <summary>
+    /// Convolves the input with the impulse response to the output.
+    /// </summary>
+    /// <param name="input">The input samples.</param>
+    /// <param name="output">The output samples. Must be at least as long as the input. Can be the same buffer as the input.</param>
+    public void Process(ReadOnlySpan<float> input, Span<float> output)
+    {
+        var head = _head;
+        if (head is null) throw new InvalidOperationException($"{nameof(SetupProcessing)} must be called before processing");
+        if (output.Length < input.Length) throw new ArgumentOutOfRangeException(nameof(output), $"The output length {output.Length} is less than the input length {input.Length}");
+
+        var tail = _tail;
+        if (tail is null)
+        {
+            head.Process(input, output);
+            return;
+        }
+
+        // Process by chunks of the preallocated tail output, in case the host sends more samples than announced
+        var tailOutput = _tailOutput;
+        int processed = 0;
+        while (processed < input.Length)
+        {
+            var count = Math.Min(input.Length - processed, tailOutput.Length);
+            var inputChunk = input.Slice(processed, count);
+            var outputChunk = output.Slice(processed, count);
+            var tailChunk = tailOutput.AsSpan(0, count);
+
+            // The tail must read the input before the head writes to the output, as they can be the same buffer
+            tail.Process(inputChunk, tailChunk);
+            head.Process(inputChunk, outputChunk);
+            for (int i = 0; i < count; i++)
+            {
+                outputChunk[i] += tailChunk[i];
+            }
+
+            processed += count;
+        }
+    }
+
+    /// <summary>
+    /// Clears the state of this convolver (e.g. when the processing is restarted).
+    /// </summary>
+    public void Reset()
+    {
+        _head?.Reset();
+        _tail?.Reset();
+    }
+}
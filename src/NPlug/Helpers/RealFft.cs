@@ -0,0 +1,287 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using System;
+using System.Numerics;
+using System.Runtime.InteropServices;
+
+namespace NPlug.Helpers;
+
+/// <summary>
+/// A Fast Fourier Transform of a real signal with a power of 2 size.
+/// </summary>
+/// <remarks>
+/// The real signal is transformed through a complex FFT of half its size followed by a split step.
+/// The spectrum is stored as separate real and imaginary parts of <see cref="SpectrumLength"/> bins (from DC to Nyquist included).
+/// All the working buffers are allocated by the constructor: <see cref="Forward"/> and <see cref="Inverse"/> don't allocate.
+/// An instance must not be used concurrently from multiple threads.
+/// </remarks>
+public sealed class RealFft
+{
+    private readonly int _halfSize;
+    private readonly int[] _bitReverse;
+    // Twiddles of the complex FFT, the twiddles of the butterflies of half size h are stored at [h - 1, 2h - 1)
+    private readonly float[] _twiddleReal;
+    private readonly float[] _twiddleImag;
+    // Twiddles of the split step, exp(-2*PI*i*k/Size) for k in [0, Size/2]
+    private readonly float[] _splitReal;
+    private readonly float[] _splitImag;
+    private readonly float[] _workReal;
+    private readonly float[] _workImag;
+
+    /// <summary>
+    /// Creates a new instance of this FFT.
+    /// </summary>
+    /// <param name="size">The number of real samples to transform. Must be a power of 2 greater or equal to 4.</param>
+    public RealFft(int size)
+    {
+        if (size < 4 || !BitOperations.IsPow2(size)) throw new ArgumentOutOfRangeException(nameof(size), size, "The size must be a power of 2 greater or equal to 4");
+
+        Size = size;
+        _halfSize = size / 2;
+        var halfSize = _halfSize;
+
+        var bitCount = BitOperations.Log2((uint)halfSize);
+        _bitReverse = new int[halfSize];
+        for (int i = 0; i < halfSize; i++)
+        {
+            int reversed = 0;
+            for (int bit = 0; bit < bitCount; bit++)
+            {
+                reversed |= ((i >> bit) & 1) << (bitCount - 1 - bit);
+            }
+            _bitReverse[i] = reversed;
+        }
+
+        _twiddleReal = new float[halfSize - 1];
+        _twiddleImag = new float[halfSize - 1];
+        for (int h = 1; h < halfSize; h <<= 1)
+        {
+            for (int j = 0; j < h; j++)
+            {
+                var angle = -Math.PI * j / h;
+                _twiddleReal[h - 1 + j] = (float)Math.Cos(angle);
+                _twiddleImag[h - 1 + j] = (float)Math.Sin(angle);
+            }
+        }
+
+        _splitReal = new float[halfSize + 1];
+        _splitImag = new float[halfSize + 1];
+        for (int k = 0; k <= halfSize; k++)
+        {
+            var angle = -2.0 * Math.PI * k / size;
+            _splitReal[k] = (float)Math.Cos(angle);
+            _splitImag[k] = (float)Math.Sin(angle);
+        }
+
+        _workReal = new float[halfSize];
+        _workImag = new float[halfSize];
+    }
+
+    /// <summary>
+    /// Gets the number of real samples transformed.
+    /// </summary>
+    public int Size { get; }
+
+    /// <summary>
+    /// Gets the number of complex bins of the spectrum (<see cref="Size"/> / 2 + 1).
+    /// </summary>
+    public int SpectrumLength => _halfSize + 1;
+
+    /// <summary>
+    /// Computes the spectrum of the specified real signal.
+    /// </summary>
+    /// <param name="input">The real signal. If it is shorter than <see cref="Size"/>, the signal is zero padded.</param>
+    /// <param name="real">The real part of the spectrum. Must be at least <see cref="SpectrumLength"/> long.</param>
+    /// <param name="imag">The imaginary part of the spectrum. Must be at least <see cref="SpectrumLength"/> long.</param>
+    public void Forward(ReadOnlySpan<float> input, Span<float> real, Span<float> imag)
+    {
+        if (input.Length > Size) throw new ArgumentOutOfRangeException(nameof(input), $"The input length {input.Length} is greater than the size {Size} of the FFT");
+        if (real.Length < SpectrumLength) throw new ArgumentOutOfRangeException(nameof(real), $"The length {real.Length} is less than the spectrum length {SpectrumLength}");
+        if (imag.Length < SpectrumLength) throw new ArgumentOutOfRangeException(nameof(imag), $"The length {imag.Length} is less than the spectrum length {SpectrumLength}");
+
+        var halfSize = _halfSize;
+        var bitReverse = _bitReverse;
+        var zr = _workReal;
+        var zi = _workImag;
+
+        // Pack even/odd samples as a complex signal, directly in bit reversed order
+        int pairCount = input.Length / 2;
+        for (int n = 0; n < pairCount; n++)
+        {
+            var index = bitReverse[n];
+            zr[index] = input[2 * n];
+            zi[index] = input[2 * n + 1];
+        }
+
+        if ((input.Length & 1) != 0)
+        {
+            var index = bitReverse[pairCount];
+            zr[index] = input[input.Length - 1];
+            zi[index] = 0.0f;
+            pairCount++;
+        }
+
+        for (int n = pairCount; n < halfSize; n++)
+        {
+            var index = bitReverse[n];
+            zr[index] = 0.0f;
+            zi[index] = 0.0f;
+        }
+
+        Transform(zr, zi);
+
+        // Split step: X[k] = Fe[k] + W^k Fo[k]
+        // with Fe[k] = (Z[k] + conj(Z[N/2-k])) / 2 and Fo[k] = (Z[k] - conj(Z[N/2-k])) / 2i
+        real[0] = zr[0] + zi[0];
+        imag[0] = 0.0f;
+        real[halfSize] = zr[0] - zi[0];
+        imag[halfSize] = 0.0f;
+        for (int k = 1; k < halfSize; k++)
+        {
+            var ar = zr[k];
+            var ai = zi[k];
+            var br = zr[halfSize - k];
+            var bi = -zi[halfSize - k];
+
+            var evenReal = 0.5f * (ar + br);
+            var evenImag = 0.5f * (ai + bi);
+            var oddReal = 0.5f * (ai - bi);
+            var oddImag = -0.5f * (ar - br);
+
+            var wr = _splitReal[k];
+            var wi = _splitImag[k];
+            real[k] = evenReal + wr * oddReal - wi * oddImag;
+            imag[k] = evenImag + wr * oddImag + wi * oddReal;
+        }
+    }
+
+    /// <summary>
+    /// Computes the real signal of the specified spectrum. This is the exact inverse of <see cref="Forward"/> (the result is scaled).
+    /// </summary>
+    /// <param name="real">The real part of the spectrum. Must be at least <see cref="SpectrumLength"/> long.</param>
+    /// <param name="imag">The imaginary part of the spectrum. Must be at least <see cref="SpectrumLength"/> long.</param>
+    /// <param name="output">The real signal. Must be at least <see cref="Size"/> long.</param>
+    public void Inverse(ReadOnlySpan<float> real, ReadOnlySpan<float> imag, Span<float> output)
+    {
+        if (real.Length < SpectrumLength) throw new ArgumentOutOfRangeException(nameof(real), $"The length {real.Length} is less than the spectrum length {SpectrumLength}");
+        if (imag.Length < SpectrumLength) throw new ArgumentOutOfRangeException(nameof(imag), $"The length {imag.Length} is less than the spectrum length {SpectrumLength}");
+        if (output.Length < Size) throw new ArgumentOutOfRangeException(nameof(output), $"The length {output.Length} is less than the size {Size} of the FFT");
+
+        var halfSize = _halfSize;
+        var bitReverse = _bitReverse;
+        var zr = _workReal;
+        var zi = _workImag;
+
+        // Merge step: Z[k] = Fe[k] + i Fo[k]
+        // with Fe[k] = (X[k] + conj(X[N/2-k])) / 2 and Fo[k] = (X[k] - conj(X[N/2-k])) W^-k / 2
+        // The result is conjugated in bit reversed order, so that the inverse is computed by the forward transform.
+        for (int k = 0; k < halfSize; k++)
+        {
+            var ar = real[k];
+            var ai = imag[k];
+            var br = real[halfSize - k];
+            var bi = -imag[halfSize - k];
+
+            var evenReal = 0.5f * (ar + br);
+            var evenImag = 0.5f * (ai + bi);
+            var diffReal = 0.5f * (ar - br);
+            var diffImag = 0.5f * (ai - bi);
+
+            var wr = _splitReal[k];
+            var wi = _splitImag[k];
+            var oddReal = diffReal * wr + diffImag * wi;
+            var oddImag = diffImag * wr - diffReal * wi;
+
+            var index = bitReverse[k];
+            zr[index] = evenReal - oddImag;
+            zi[index] = -(evenImag + oddReal);
+        }
+
+        Transform(zr, zi);
+
+        var scale = 1.0f / halfSize;
+        for (int n = 0; n < halfSize; n++)
+        {
+            output[2 * n] = zr[n] * scale;
+            output[2 * n + 1] = -zi[n] * scale;
+        }
+    }
+
+    /// <summary>
+    /// In-place radix-2 decimation in time complex FFT. The input is expected in bit reversed order.
+    /// </summary>
+    private void Transform(float[] real, float[] imag)
+    {
+        var halfSize = _halfSize;
+
+        // First stage, twiddle is 1
+        for (int i = 0; i < halfSize; i += 2)
+        {
+            var ar = real[i];
+            var ai = imag[i];
+            var br = real[i + 1];
+            var bi = imag[i + 1];
+            real[i] = ar + br;
+            imag[i] = ai + bi;
+            real[i + 1] = ar - br;
+            imag[i + 1] = ai - bi;
+        }
+
+        for (int h = 2; h < halfSize; h <<= 1)
+        {
+            if (Vector.IsHardwareAccelerated && h >= Vector<float>.Count)
+            {
+                var twiddleReal = MemoryMarshal.Cast<float, Vector<float>>(_twiddleReal.AsSpan(h - 1, h));
+                var twiddleImag = MemoryMarshal.Cast<float, Vector<float>>(_twiddleImag.AsSpan(h - 1, h));
+                for (int start = 0; start < halfSize; start += 2 * h)
+                {
+                    var topReal = MemoryMarshal.Cast<float, Vector<float>>(real.AsSpan(start, h));
+                    var topImag = MemoryMarshal.Cast<float, Vector<float>>(imag.AsSpan(start, h));
+                    var bottomReal = MemoryMarshal.Cast<float, Vector<float>>(real.AsSpan(start + h, h));
+                    var bottomImag = MemoryMarshal.Cast<float, Vector<float>>(imag.AsSpan(start + h, h));
+                    for (int j = 0; j < twiddleReal.Length; j++)
+                    {
+                        var wr = twiddleReal[j];
+                        var wi = twiddleImag[j];
+                        var br = bottomReal[j];
+                        var bi = bottomImag[j];
+                        var tr = wr * br - wi * bi;
+                        var ti = wr * bi + wi * br;
+                        var ar = topReal[j];
+                        var ai = topImag[j];
+                        topReal[j] = ar + tr;
+                        topImag[j] = ai + ti;
+                        bottomReal[j] = ar - tr;
+                        bottomImag[j] = ai - ti;
+                    }
+                }
+            }
+            else
+            {
+                var twiddleOffset = h - 1;
+                for (int start = 0; start < halfSize; start += 2 * h)
+                {
+                    for (int j = 0; j < h; j++)
+                    {
+                        var wr = _twiddleReal[twiddleOffset + j];
+                        var wi = _twiddleImag[twiddleOffset + j];
+                        var top = start + j;
+                        var bottom = top + h;
+                        var br = real[bottom];
+                        var bi = imag[bottom];
+                        var tr = wr * br - wi * bi;
+                        var ti = wr * bi + wi * br;
+                        var ar = real[top];
+                        var ai = imag[top];
+                        real[top] = ar + tr;
+                        imag[top] = ai + ti;
+                        real[bottom] = ar - tr;
+                        imag[bottom] = ai - ti;
+                    }
+                }
+            }
+        }
+    }
+}
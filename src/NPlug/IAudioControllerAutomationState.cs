@@ -2,6 +2,8 @@
 // Licensed under the BSD-Clause 2 license.
 // See license.txt file in the project root for full license information.
 
+using NPlug.Interop;
+
 namespace NPlug;
 
 /// <summary>
@@ -20,4 +22,9 @@ public interface IAudioControllerAutomationState : IAudioController
     /// Sets the current Automation state.
     /// </summary>
     void SetAutomationState(AudioControllerAutomationStates state);
+
+    /// <summary>
+    /// Gets the native <c>IAutomationState</c> interface of the COM object of this controller.
+    /// </summary>
+    internal unsafe void* QueryNativeInterface(LibVst.ComObject comObject) => comObject.QueryInterface<LibVst.IAutomationState>();
 }
\ No newline at end of file
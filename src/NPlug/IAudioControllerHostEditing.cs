@@ -2,6 +2,8 @@
 // Licensed under the BSD-Clause 2 license.
 // See license.txt file in the project root for full license information.
 
+using NPlug.Interop;
+
 namespace NPlug;
 
 /// <summary>
@@ -39,4 +41,9 @@ public interface IAudioControllerHostEditing : IAudioController
     /// Called after a beginEditFromHost and a sequence of setParamNormalized.
     /// </summary>
     void EndEditFromHost(AudioParameterId parameterId);
+
+    /// <summary>
+    /// Gets the native <c>IEditControllerHostEditing</c> interface of the COM object of this controller.
+    /// </summary>
+    internal unsafe void* QueryNativeInterface(LibVst.ComObject comObject) => comObject.QueryInterface<LibVst.IEditControllerHostEditing>();
 }
\ No newline at end of file
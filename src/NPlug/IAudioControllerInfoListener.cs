@@ -2,6 +2,8 @@
 // Licensed under the BSD-Clause 2 license.
 // See license.txt file in the project root for full license information.
 
+using NPlug.Interop;
+
 namespace NPlug;
 
 /// <summary>
@@ -114,4 +116,9 @@ public interface IAudioControllerInfoListener : IAudioController
     /// Receive the channel context infos from host.
     /// </summary>
     void SetChannelContextInfos(in AudioAttributeList list);
+
+    /// <summary>
+    /// Gets the native <c>IInfoListener</c> interface of the COM object of this controller.
+    /// </summary>
+    internal unsafe void* QueryNativeInterface(LibVst.ComObject comObject) => comObject.QueryInterface<LibVst.IInfoListener>();
 }
\ No newline at end of file
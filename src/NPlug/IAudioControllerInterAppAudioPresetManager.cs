@@ -2,6 +2,8 @@
 // Licensed under the BSD-Clause 2 license.
 // See license.txt file in the project root for full license information.
 
+using NPlug.Interop;
+
 namespace NPlug;
 
 /// <summary>
@@ -34,4 +36,9 @@ public interface IAudioControllerInterAppAudioPresetManager : IAudioController
     /// Load the previous available preset
     /// </summary>
     void LoadPreviousPreset();
+
+    /// <summary>
+    /// Gets the native <c>IInterAppAudioPresetManager</c> interface of the COM object of this controller.
+    /// </summary>
+    internal unsafe void* QueryNativeInterface(LibVst.ComObject comObject) => comObject.QueryInterface<LibVst.IInterAppAudioPresetManager>();
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 // Licensed under the BSD-Clause 2 license.
 // See license.txt file in the project root for full license information.
 
+using NPlug.Interop;
+
 namespace NPlug;
 
 /// <summary>
@@ -27,4 +29,9 @@ public interface IAudioControllerKeySwitch : IAudioController
     /// Returns key switch info.
     /// </summary>
     AudioControllerKeySwitchInfo GetKeySwitchInfo(int busIndex, short channel, int keySwitchIndex);
+
+    /// <summary>
+    /// Gets the native <c>IKeyswitchController</c> interface of the COM object of this controller.
+    /// </summary>
+    internal unsafe void* QueryNativeInterface(LibVst.ComObject comObject) => comObject.QueryInterface<LibVst.IKeyswitchController>();
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 // Licensed under the BSD-Clause 2 license.
 // See license.txt file in the project root for full license information.
 
+using NPlug.Interop;
+
 namespace NPlug;
 
 /// <summary>
@@ -76,4 +78,9 @@ public interface IAudioControllerMidiLearn : IAudioController
     /// Called on live input MIDI-CC change associated to a given bus index and MIDI channel
     /// </summary>
     bool TryOnLiveMidiControllerInput(int busIndex, short channel, AudioMidiControllerNumber midiCC);
+
+    /// <summary>
+    /// Gets the native <c>IMidiLearn</c> interface of the COM object of this controller.
+    /// </summary>
+    internal unsafe void* QueryNativeInterface(LibVst.ComObject comObject) => comObject.QueryInterface<LibVst.IMidiLearn>();
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 // Licensed under the BSD-Clause 2 license.
 // See license.txt file in the project root for full license information.
 
+using NPlug.Interop;
+
 namespace NPlug;
 
 /// <summary>
@@ -41,4 +43,9 @@ public interface IAudioControllerNoteExpression : IAudioController
     /// Converts the user readable representation to the normalized note change value.
     /// </summary>
     double GetNoteExpressionValueByString(int busIndex, short channel, AudioNoteExpressionTypeId id, string valueAsString);
+
+    /// <summary>
+    /// Gets the native <c>INoteExpressionController</c> interface of the COM object of this controller.
+    /// </summary>
+    internal unsafe void* QueryNativeInterface(LibVst.ComObject comObject) => comObject.QueryInterface<LibVst.INoteExpressionController>();
 }
\ No newline at end of file
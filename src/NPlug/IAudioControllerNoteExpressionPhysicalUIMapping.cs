@@ -3,6 +3,7 @@
 // See license.txt file in the project root for full license information.
 
 using System;
+using NPlug.Interop;
 
 namespace NPlug;
 
@@ -74,4 +75,9 @@ public interface IAudioControllerNoteExpressionPhysicalUIMapping : IAudioControl
     /// and channel.
     /// </summary>
     bool TryGetPhysicalUIMapping(int busIndex, short channel, Span<AudioPhysicalUIMap> mapList);
+
+    /// <summary>
+    /// Gets the native <c>INoteExpressionPhysicalUIMapping</c> interface of the COM object of this controller.
+    /// </summary>
+    internal unsafe void* QueryNativeInterface(LibVst.ComObject comObject) => comObject.QueryInterface<LibVst.INoteExpressionPhysicalUIMapping>();
 }
\ No newline at end of file
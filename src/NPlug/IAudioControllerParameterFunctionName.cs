@@ -2,6 +2,8 @@
 // Licensed under the BSD-Clause 2 license.
 // See license.txt file in the project root for full license information.
 
+using NPlug.Interop;
+
 namespace NPlug;
 
 /// <summary>
@@ -89,4 +91,9 @@ public interface IAudioControllerParameterFunctionName : IAudioController
     /// <param name="paramId"></param>
     /// <returns></returns>
     bool TryGetParameterIdFromFunctionName(AudioUnitId unitId, string functionName, out AudioParameterId paramId);
+
+    /// <summary>
+    /// Gets the native <c>IParameterFunctionName</c> interface of the COM object of this controller.
+    /// </summary>
+    internal unsafe void* QueryNativeInterface(LibVst.ComObject comObject) => comObject.QueryInterface<LibVst.IParameterFunctionName>();
 }
\ No newline at end of file
@@ -111,4 +111,9 @@ public interface IAudioControllerXmlRepresentation : IAudioController
     /// Retrieves a stream containing a XmlRepresentation for a wanted representation info
     /// </summary>
     void GetXmlRepresentationStream(in AudioControllerRepresentationInfo info, Stream output);
+
+    /// <summary>
+    /// Gets the native <c>IXmlRepresentationController</c> interface of the COM object of this controller.
+    /// </summary>
+    internal unsafe void* QueryNativeInterface(LibVst.ComObject comObject) => comObject.QueryInterface<LibVst.IXmlRepresentationController>();
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 // Licensed under the BSD-Clause 2 license.
 // See license.txt file in the project root for full license information.
 
+using System;
+using NPlug.Interop;
+
 namespace NPlug;
 
 /// <summary>
@@ -146,4 +149,14 @@ public interface IAudioPluginView
     /// </summary>
     /// <remarks>IParameterFinder</remarks>
     bool TryFindParameter(int xPos, int yPos, out AudioParameterId parameterId);
+
+    /// <summary>
+    /// Gets the native interface of the COM object of this view matching the requested <paramref name="iid"/> (<c>IPlugView</c>, <c>IParameterFinder</c> or <c>IPlugViewContentScaleSupport</c>).
+    /// </summary>
+    internal unsafe void* QueryNativeInterface(Guid* iid, LibVst.ComObject comObject)
+    {
+        if (*iid == *LibVst.IParameterFinder.NativeGuid) return comObject.QueryInterface<LibVst.IParameterFinder>();
+        if (*iid == *LibVst.IPlugViewContentScaleSupport.NativeGuid) return comObject.QueryInterface<LibVst.IPlugViewContentScaleSupport>();
+        return comObject.QueryInterface<LibVst.IPlugView>();
+    }
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 // Licensed under the BSD-Clause 2 license.
 // See license.txt file in the project root for full license information.
 
+using NPlug.Interop;
+
 namespace NPlug;
 
 /// <summary>
@@ -41,4 +43,9 @@ public interface IAudioProcessorPrefetchable : IAudioProcessor
     /// Retrieve the current prefetch support. Use <see cref="IAudioControllerHandler.RestartComponent"/> with <see cref="AudioRestartFlags.PrefetchableSupportChanged"/> to inform the host that this support has changed.
     /// </summary>
     AudioProcessorPrefetchableSupport PrefetchableSupport { get; }
+
+    /// <summary>
+    /// Gets the native <c>IPrefetchableSupport</c> interface of the COM object of this processor.
+    /// </summary>
+    internal unsafe void* QueryNativeInterface(LibVst.ComObject comObject) => comObject.QueryInterface<LibVst.IPrefetchableSupport>();
 }
\ No newline at end of file
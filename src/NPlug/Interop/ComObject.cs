@@ -154,44 +154,6 @@ internal static partial class LibVst
             }
         }
 
-        public IntPtr QueryInterface(in Guid guidToFind)
-        {
-            bool lockTaken = false;
-            try
-            {
-                _lock.Enter(ref lockTaken);
-                _refCount++;
-
-
-                for (int i = 0; i < _interfaceCount; i++)
-                {
-                    var handle = _handles + i;
-                    if (handle->Guid.Equals(guidToFind))
-                    {
-                        return (IntPtr)handle;
-                    }
-                }
-
-                if (_interfaceCount == MaxInterfacesPerObject)
-                {
-                    _refCount--;
-                    throw new InvalidOperationException($"Cannot create more handle for a COM object. Maximum of {MaxInterfacesPerObject} interfaces has been reached.");
-                }
-
-                var nextHandle = _handles + _interfaceCount;
-                _interfaceCount++;
-
-                nextHandle->Vtbl = (void**)ComObjectManager.GetVtbl(guidToFind);
-                nextHandle->Guid = guidToFind;
-                nextHandle->Handle = _thisHandle;
-                return (IntPtr)nextHandle;
-            }
-            finally
-            {
-                if (lockTaken) _lock.Exit();
-            }
-        }
-
         public void Reset()
         {
             for (int i = 0; i < _interfaceCount; i++)
@@ -213,8 +175,6 @@ internal static partial class LibVst
 
     public sealed unsafe partial class ComObjectManager : IDisposable
     {
-        private static readonly Dictionary<Guid, Func<IntPtr>> MapGuidToVtblFunc = new Dictionary<Guid, Func<IntPtr>>();
-
         public static readonly ComObjectManager Instance = new ComObjectManager();
         
         private const int DefaultComObjectCacheCount = 16;
@@ -282,25 +242,15 @@ internal static partial class LibVst
             }
         }
 
-        private static void Register<T>() where T : struct, INativeGuid, INativeVtbl
-        {
-            MapGuidToVtblFunc[*(T.NativeGuid)] = () => (IntPtr)VtblInitializer<T>.Vtbl;
-        }
-
         public static IntPtr GetVtbl<T>() where T : struct, INativeGuid, INativeVtbl
         {
             return (IntPtr)VtblInitializer<T>.Vtbl;
         }
 
-        public static IntPtr GetVtbl(in Guid guid)
-        {
-            if (MapGuidToVtblFunc.TryGetValue(guid, out var vtbFuncl))
-            {
-                return vtbFuncl();
-            }
-            return IntPtr.Zero;
-        }
-
+        /// <summary>
+        /// Vtbl of an interface, allocated and initialized the first time the interface is queried.
+        /// Only the interfaces referenced through <see cref="GetVtbl{T}"/> are kept by the trimmer.
+        /// </summary>
         private static class VtblInitializer<T> where T : INativeVtbl
         {
             public static readonly void** Vtbl;
@@ -311,11 +261,6 @@ internal static partial class LibVst
                 T.InitializeVtbl(Vtbl);
             }
         }
-
-        static ComObjectManager()
-        {
-            RegisterAllInterfaces();
-        }
     }
 
     public unsafe interface INativeGuid
@@ -49,59 +49,74 @@ internal static unsafe partial class LibVst
         private static ComObjectHandle* Get(FUnknown* self) => (ComObjectHandle*)self;
 
         // Global map VST internal types to public types
+        // This is the only place where CCW interfaces are registered, so that the vtbl of an interface
+        // not listed here (or not queried explicitly) can be removed by the trimmer.
+        // The interfaces implemented by the NPlug base classes are always used and are queried directly.
+        // The optional interfaces are queried through their managed interface (QueryNativeInterface), so that their vtbl
+        // is only kept if a type implementing the managed interface is kept. The requested iid is only passed to
+        // IAudioPluginView, which maps several native interfaces.
         private static readonly Dictionary<Guid, TryQueryInterfaceDelegate> MapGuidToDelegate = new()
         {
+            { FUnknown.IId, TryMatchQueryInterface<FUnknown, object> },
             { IAudioPresentationLatency.IId, TryMatchQueryInterface<IAudioPresentationLatency, IAudioProcessor> },
             { IAudioProcessor.IId, TryMatchQueryInterface<IAudioProcessor, NPlug.IAudioProcessor> },
-            { IAutomationState.IId, TryMatchQueryInterface<IAutomationState, IAudioControllerAutomationState> },
+            { IAutomationState.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioControllerAutomationState target ? target.QueryNativeInterface(comObject) : null, pInterface) },
             { IComponent.IId, TryMatchQueryInterface<IComponent, NPlug.IAudioProcessor> },
             { IConnectionPoint.IId, TryMatchQueryInterface<IConnectionPoint, IAudioConnectionPoint> },
             { IContextMenuTarget.IId, TryMatchQueryInterface<IContextMenuTarget, System.Delegate> },
             { IEditController.IId, TryMatchQueryInterface<IEditController, NPlug.IAudioController> },
             { IEditController2.IId, TryMatchQueryInterface<IEditController2, IAudioControllerExtended> },
-            { IEditControllerHostEditing.IId, TryMatchQueryInterface<IEditControllerHostEditing, IAudioControllerHostEditing> },
-            { IInfoListener.IId, TryMatchQueryInterface<IInfoListener, IAudioControllerInfoListener> },
-            { IInterAppAudioPresetManager.IId, TryMatchQueryInterface<IInterAppAudioPresetManager, IAudioControllerInterAppAudioPresetManager> },
-            { IKeyswitchController.IId, TryMatchQueryInterface<IKeyswitchController, IAudioControllerKeySwitch> },
-            { IMidiLearn.IId, TryMatchQueryInterface<IMidiLearn, IAudioControllerMidiLearn> },
+            { IEditControllerHostEditing.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioControllerHostEditing target ? target.QueryNativeInterface(comObject) : null, pInterface) },
+            { IInfoListener.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioControllerInfoListener target ? target.QueryNativeInterface(comObject) : null, pInterface) },
+            { IInterAppAudioPresetManager.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioControllerInterAppAudioPresetManager target ? target.QueryNativeInterface(comObject) : null, pInterface) },
+            { IKeyswitchController.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioControllerKeySwitch target ? target.QueryNativeInterface(comObject) : null, pInterface) },
+            { IMidiLearn.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioControllerMidiLearn target ? target.QueryNativeInterface(comObject) : null, pInterface) },
             { IMidiMapping.IId, TryMatchQueryInterface<IMidiMapping, IAudioControllerMidiMapping> },
-            { INoteExpressionController.IId, TryMatchQueryInterface<INoteExpressionController, IAudioControllerNoteExpression> },
-            { INoteExpressionPhysicalUIMapping.IId, TryMatchQueryInterface<INoteExpressionPhysicalUIMapping, IAudioControllerNoteExpressionPhysicalUIMapping> },
-            { IParameterFinder.IId, TryMatchQueryInterface<IParameterFinder , IAudioPluginView> },
-            { IParameterFunctionName.IId, TryMatchQueryInterface<IParameterFunctionName, IAudioControllerParameterFunctionName> },
+            { INoteExpressionController.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioControllerNoteExpression target ? target.QueryNativeInterface(comObject) : null, pInterface) },
+            { INoteExpressionPhysicalUIMapping.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioControllerNoteExpressionPhysicalUIMapping target ? target.QueryNativeInterface(comObject) : null, pInterface) },
+            { IParameterFinder.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioPluginView target ? target.QueryNativeInterface(iid, comObject) : null, pInterface) },
+            { IParameterFunctionName.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioControllerParameterFunctionName target ? target.QueryNativeInterface(comObject) : null, pInterface) },
             { IPluginBase.IId, TryMatchQueryInterface<IPluginBase, IAudioPluginComponent> },
             { IPluginFactory.IId, TryMatchQueryInterface<IPluginFactory, IAudioPluginFactory> },
             { IPluginFactory2.IId, TryMatchQueryInterface<IPluginFactory2, IAudioPluginFactory> },
             { IPluginFactory3.IId, TryMatchQueryInterface<IPluginFactory3, IAudioPluginFactory> },
-            { IPlugView.IId, TryMatchQueryInterface<IPlugView, IAudioPluginView> },
-            { IPlugViewContentScaleSupport.IId, TryMatchQueryInterface<IPlugViewContentScaleSupport, IAudioPluginView> },
-            { IPrefetchableSupport.IId, TryMatchQueryInterface<IPrefetchableSupport, IAudioProcessorPrefetchable> },
+            { IPlugView.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioPluginView target ? target.QueryNativeInterface(iid, comObject) : null, pInterface) },
+            { IPlugViewContentScaleSupport.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioPluginView target ? target.QueryNativeInterface(iid, comObject) : null, pInterface) },
+            { IPrefetchableSupport.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioProcessorPrefetchable target ? target.QueryNativeInterface(comObject) : null, pInterface) },
             { IProcessContextRequirements.IId, TryMatchQueryInterface<IProcessContextRequirements, NPlug.IAudioProcessor> },
             { IProgramListData.IId, TryMatchQueryInterface<IProgramListData, IAudioProcessorProgramListData> },
             { ITestPlugProvider.IId, TryMatchQueryInterface<ITestPlugProvider, IAudioTestProvider> },
             { ITestPlugProvider2.IId, TryMatchQueryInterface<ITestPlugProvider2, IAudioTestProvider> },
             { IUnitData.IId, TryMatchQueryInterface<IUnitData, IAudioProcessorUnitData> },
             { IUnitInfo.IId, TryMatchQueryInterface<IUnitInfo, IAudioControllerUnitInfo> },
-            { IXmlRepresentationController.IId, TryMatchQueryInterface<IXmlRepresentationController, IAudioControllerXmlRepresentation> },
+            { IXmlRepresentationController.IId, (iid, comObject, pInterface) => TryMatchQueryInterface(iid, comObject.Target is IAudioControllerXmlRepresentation target ? target.QueryNativeInterface(comObject) : null, pInterface) },
         };
 
 
 
+        /// <summary>
+        /// Tries to get the native interface <paramref name="iid"/> of the specified COM object, if its target implements the matching managed interface.
+        /// </summary>
+        public static bool TryQueryInterface(Guid* iid, ComObject comObject, void** pInterface)
+        {
+            *pInterface = (void*)0;
+            return MapGuidToDelegate.TryGetValue(*iid, out var match) && match(iid, comObject, pInterface);
+        }
+
         private static partial ComResult queryInterface_ToManaged(FUnknown* self, Guid* _iid, void** obj)
         {
-            *obj = (void*)0;
-            var bridge = Get(self)->ComObject;
-            return MapGuidToDelegate.TryGetValue(*_iid, out var match) && match(_iid, bridge, obj) ? ComResult.Ok : ComResult.NoInterface;
+            return TryQueryInterface(_iid, Get(self)->ComObject, obj) ? ComResult.Ok : ComResult.NoInterface;
         }
 
         private static bool TryMatchQueryInterface<TNative, TUser>(Guid* iid, ComObject comObject, void** pInterface) where TNative : unmanaged, INativeGuid, INativeVtbl
         {
-            bool result = false;
-            if (comObject.Target is TUser)
-            {
-                *pInterface = (void*)comObject.QueryInterface<TNative>();
-                result = true;
-            }
+            return TryMatchQueryInterface(iid, comObject.Target is TUser ? comObject.QueryInterface<TNative>() : null, pInterface);
+        }
+
+        private static bool TryMatchQueryInterface(Guid* iid, void* nativeInterface, void** pInterface)
+        {
+            *pInterface = nativeInterface;
+            var result = nativeInterface != null;
             // Log which interface is implemented
             if (InteropHelper.IsTracerEnabled)
             {
@@ -63,15 +63,15 @@ internal static unsafe partial class LibVst
             if (pluginComponent != null)
             {
                 var comObject = ComObjectManager.Instance.GetOrCreateComObject(pluginComponent);
-                var nativePointerForRequestedInterfaceIid = comObject.QueryInterface(*(Guid*)_iid.Value);
-                if (nativePointerForRequestedInterfaceIid != IntPtr.Zero)
+                if (FUnknown.TryQueryInterface((Guid*)_iid.Value, comObject, obj))
                 {
-                    *obj = (void*)nativePointerForRequestedInterfaceIid;
                     comResult = true;
                 }
-                else
+                else if (comObject.ReferenceCount == 0)
                 {
-                    comObject.Dispose();
+                    // The interface is not supported: unregister the COM object of the new instance and return it to the cache
+                    comObject.Reset();
+                    ComObjectManager.Instance.Return(comObject);
                 }
             }
             return comResult;
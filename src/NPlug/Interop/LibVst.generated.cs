@@ -29538,80 +29538,6 @@ internal static partial class LibVst
         public static ReadOnlySpan<byte> kOneShot_u8 => "One Shot\0"u8;
     }
     
-    public partial class ComObjectManager
-    {
-        private static void RegisterAllInterfaces()
-        {
-            Register<FUnknown>();
-            Register<IBStream>();
-            Register<IAttributes>();
-            Register<IAttributes2>();
-            Register<IPluginBase>();
-            Register<IPluginFactory>();
-            Register<IPluginFactory2>();
-            Register<IPluginFactory3>();
-            Register<IStringResult>();
-            Register<IPlugView>();
-            Register<IPlugFrame>();
-            Register<IPlugViewContentScaleSupport>();
-            Register<IWaylandHost>();
-            Register<IWaylandFrame>();
-            Register<IEventHandler>();
-            Register<ITimerHandler>();
-            Register<IRunLoop>();
-            Register<IAttributeList>();
-            Register<IStreamAttributes>();
-            Register<IComponent>();
-            Register<IEventList>();
-            Register<IParameterChanges>();
-            Register<IParamValueQueue>();
-            Register<IAudioProcessor>();
-            Register<IAudioPresentationLatency>();
-            Register<IProcessContextRequirements>();
-            Register<IAutomationState>();
-            Register<IContextMenu>();
-            Register<IContextMenuTarget>();
-            Register<IComponentHandler3>();
-            Register<IDataExchangeHandler>();
-            Register<IDataExchangeReceiver>();
-            Register<IComponentHandler>();
-            Register<IComponentHandler2>();
-            Register<IComponentHandlerBusActivation>();
-            Register<IProgress>();
-            Register<IEditController>();
-            Register<IEditController2>();
-            Register<IMidiMapping>();
-            Register<IEditControllerHostEditing>();
-            Register<IComponentHandlerSystemTime>();
-            Register<INoteExpressionController>();
-            Register<IKeyswitchController>();
-            Register<IMessage>();
-            Register<IConnectionPoint>();
-            Register<IHostApplication>();
-            Register<IVst3WrapperMPESupport>();
-            Register<IInterAppAudioPresetManager>();
-            Register<IInterAppAudioHost>();
-            Register<IMidiLearn>();
-            Register<IMidiMapping2>();
-            Register<IMidiLearn2>();
-            Register<IParameterFunctionName>();
-            Register<INoteExpressionPhysicalUIMapping>();
-            Register<IPlugInterfaceSupport>();
-            Register<IParameterFinder>();
-            Register<IPrefetchableSupport>();
-            Register<IRemapParamID>();
-            Register<IXmlRepresentationController>();
-            Register<ITestPlugProvider>();
-            Register<ITestPlugProvider2>();
-            Register<IUnitHandler>();
-            Register<IUnitHandler2>();
-            Register<IUnitInfo>();
-            Register<IProgramListData>();
-            Register<IUnitData>();
-            Register<IInfoListener>();
-        }
-    }
-    
     private static Dictionary<Guid, string> GetMapGuidToName()
     {
         return new Dictionary<Guid, string>()
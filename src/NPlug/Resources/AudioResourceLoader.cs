@@ -0,0 +1,159 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using System;
+using System.Threading;
+
+namespace NPlug.Resources;
+
+/// <summary>
+/// A background thread loading heavy resources (samples, impulse responses, models...) for the slots created by <see cref="CreateSlot{TRequest,TResource}"/>
+/// and reclaiming the resources retired by the audio thread.
+/// </summary>
+/// <remarks>
+/// Typical usage from an <see cref="AudioProcessor{TAudioProcessorModel}"/>:
+/// - Create a slot with <c>ResourceLoader.CreateSlot</c> from <c>Initialize</c>.
+/// - Call <see cref="AudioResourceSlot{TRequest,TResource}.RequestLoad"/> when a resource must change (e.g. from <c>RestoreState</c>),
+///   or <see cref="AudioResourceSlot{TRequest,TResource}.TryRequestLoad"/> from the audio thread (e.g. on a program change).
+/// - Call <see cref="AudioResourceSlot{TRequest,TResource}.Acquire"/> at the start of <c>ProcessMain</c> and use the returned resource for the block.
+///
+/// The thread is started when the first slot is created and is stopped by <see cref="Dispose"/>.
+/// The loader thread sleeps until a request is signaled by <see cref="AudioResourceSlot{TRequest,TResource}.RequestLoad"/>.
+/// The audio thread never signals or waits on the loader thread: the loader thread polls the slots every <see cref="PollingInterval"/>
+/// only while a published resource has not been acquired or retired by the audio thread, and for the slots accepting requests from the audio thread.
+/// </remarks>
+public sealed class AudioResourceLoader : IDisposable
+{
+    private readonly object _lock;
+    private readonly string _name;
+    private readonly ManualResetEventSlim _wakeEvent;
+    private readonly CancellationTokenSource _cancellationTokenSource;
+    private AudioResourceSlot[] _slots;
+    private Thread? _thread;
+    private bool _disposed;
+
+    /// <summary>
+    /// Creates a new instance of this loader.
+    /// </summary>
+    /// <param name="name">The name of the loader thread.</param>
+    public AudioResourceLoader(string name = "NPlug Resource Loader")
+    {
+        _lock = new object();
+        _name = name;
+        _wakeEvent = new ManualResetEventSlim(false);
+        _cancellationTokenSource = new CancellationTokenSource();
+        _slots = Array.Empty<AudioResourceSlot>();
+        PollingInterval = TimeSpan.FromMilliseconds(5);
+    }
+
+    /// <summary>
+    /// Gets or sets the interval at which the loader thread checks for retired resources and for the requests made from the audio thread, when it has to poll. Default is 5ms.
+    /// </summary>
+    public TimeSpan PollingInterval { get; set; }
+
+    /// <summary>
+    /// Gets a boolean indicating whether this loader has been disposed.
+    /// </summary>
+    public bool IsDisposed => Volatile.Read(ref _disposed);
+
+    /// <summary>
+    /// Creates a new slot loading its resources on the thread of this loader.
+    /// </summary>
+    /// <typeparam name="TRequest">The type of the description of a resource to load.</typeparam>
+    /// <typeparam name="TResource">The type of the resource loaded.</typeparam>
+    /// <param name="load">The function loading a resource from a request, called on the loader thread. Can return null to keep the current resource. The cancellation token is cancelled when this loader is disposed.</param>
+    /// <param name="retiredCapacity">The number of retired resources that can wait to be reclaimed by the loader thread.</param>
+    /// <param name="allowAudioThreadRequests"><c>true</c> to allow <see cref="AudioResourceSlot{TRequest,TResource}.TryRequestLoad"/> from the audio thread. The loader thread then polls this slot every <see cref="PollingInterval"/>.</param>
+    /// <returns>A new slot.</returns>
+    /// <remarks>This method must not be called from the audio thread, as it can start the loader thread.</remarks>
+    public AudioResourceSlot<TRequest, TResource> CreateSlot<TRequest, TResource>(Func<TRequest, CancellationToken, TResource?> load, int retiredCapacity = 4, bool allowAudioThreadRequests = false) where TResource : class
+    {
+        ArgumentNullException.ThrowIfNull(load);
+        ArgumentOutOfRangeException.ThrowIfNegativeOrZero(retiredCapacity);
+
+        var slot = new AudioResourceSlot<TRequest, TResource>(this, load, retiredCapacity, allowAudioThreadRequests);
+        lock (_lock)
+        {
+            ObjectDisposedException.ThrowIf(_disposed, this);
+
+            // Copy on write, the loader thread reads the array without lock
+            var slots = new AudioResourceSlot[_slots.Length + 1];
+            _slots.CopyTo(slots, 0);
+            slots[^1] = slot;
+            Volatile.Write(ref _slots, slots);
+
+            if (_thread is null)
+            {
+                _thread = new Thread(Run)
+                {
+                    Name = _name,
+                    IsBackground = true,
+                    Priority = ThreadPriority.BelowNormal
+                };
+                _thread.Start();
+            }
+        }
+
+        // Let the loader thread know if it has to poll the new slot
+        Wake();
+        return slot;
+    }
+
+    /// <summary>
+    /// Stops the loader thread and disposes all the resources of the slots. This method must not be called while the audio thread is processing.
+    /// </summary>
+    /// <remarks>
+    /// This method waits for the load in progress, if any, to complete.
+    /// </remarks>
+    public void Dispose()
+    {
+        Thread? thread;
+        lock (_lock)
+        {
+            if (_disposed) return;
+            Volatile.Write(ref _disposed, true);
+            thread = _thread;
+        }
+
+        _cancellationTokenSource.Cancel();
+        _wakeEvent.Set();
+        thread?.Join();
+
+        foreach (var slot in _slots)
+        {
+            slot.ReleaseAll();
+        }
+
+        // The wake event is not disposed, as a slot can still signal it: it doesn't hold a kernel handle, its WaitHandle is never used
+        _cancellationTokenSource.Dispose();
+    }
+
+    /// <summary>
+    /// Wakes up the loader thread. Must not be called from the audio thread.
+    /// </summary>
+    internal void Wake() => _wakeEvent.Set();
+
+    private void Run()
+    {
+        var cancellationToken = _cancellationTokenSource.Token;
+        var needsPolling = false;
+        while (true)
+        {
+            // Sleep until a request is signaled, or poll if the audio thread can hand back a resource or request a load
+            _wakeEvent.Wait(needsPolling ? PollingInterval : Timeout.InfiniteTimeSpan);
+            // A request signaled before the reset is already visible to the scan below, a request signaled after sets the event again
+            _wakeEvent.Reset();
+            if (cancellationToken.IsCancellationRequested) break;
+
+            needsPolling = false;
+            var slots = Volatile.Read(ref _slots);
+            foreach (var slot in slots)
+            {
+                slot.CollectRetired();
+                slot.RunPendingLoad(cancellationToken);
+                needsPolling |= slot.NeedsPolling;
+            }
+        }
+    }
+}
@@ -0,0 +1,272 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using System;
+using System.Threading;
+
+namespace NPlug.Resources;
+
+/// <summary>
+/// Base class of a slot created by <see cref="AudioResourceLoader.CreateSlot{TRequest,TResource}"/>.
+/// </summary>
+public abstract class AudioResourceSlot
+{
+    internal AudioResourceSlot(AudioResourceLoader loader)
+    {
+        Loader = loader;
+    }
+
+    /// <summary>
+    /// Gets the loader running the loads of this slot.
+    /// </summary>
+    public AudioResourceLoader Loader { get; }
+
+    /// <summary>
+    /// Runs the latest requested load, if any. Called from the loader thread.
+    /// </summary>
+    internal abstract void RunPendingLoad(CancellationToken cancellationToken);
+
+    /// <summary>
+    /// Reclaims the resources retired by the audio thread. Called from the loader thread.
+    /// </summary>
+    internal abstract void CollectRetired();
+
+    /// <summary>
+    /// Reclaims all the resources of this slot. Called once the loader thread is stopped.
+    /// </summary>
+    internal abstract void ReleaseAll();
+
+    /// <summary>
+    /// Gets a boolean indicating whether the loader thread must poll this slot, as the audio thread can modify it without signaling the loader thread.
+    /// </summary>
+    internal abstract bool NeedsPolling { get; }
+}
+
+/// <summary>
+/// Publishes immutable resources loaded by the thread of an <see cref="AudioResourceLoader"/> to the audio thread without locks.
+/// </summary>
+/// <typeparam name="TRequest">The type of the description of a resource to load (e.g. a file path, a program index...).</typeparam>
+/// <typeparam name="TResource">The type of the resource loaded. It should not be modified once published. If it implements <see cref="IDisposable"/>, it is disposed by the loader thread once retired.</typeparam>
+/// <remarks>
+/// A loaded resource is published by exchanging a single reference. The audio thread picks the latest published resource with <see cref="Acquire"/>
+/// at the start of a block, and the previous resource is retired: the start of a block is the point where the audio thread no longer references it.
+/// Retired resources are handed back through a fixed-size queue to the loader thread, which disposes them: no resource is disposed or allocated on the audio thread.
+/// If the queue is full, the audio thread keeps its current resource and retries at the next block.
+///
+/// Requests are published with a sequence number: the loader thread copies the latest request without taking a lock, and retries if a request was written meanwhile.
+/// Threads requesting a load only exclude each other: the audio thread uses <see cref="TryRequestLoad"/>, which gives up instead of waiting for another thread.
+/// </remarks>
+public sealed class AudioResourceSlot<TRequest, TResource> : AudioResourceSlot where TResource : class
+{
+    private readonly Func<TRequest, CancellationToken, TResource?> _load;
+    private readonly TResource?[] _retired;
+    private TRequest? _request;
+    private int _requestWriteLock;
+    private int _requestSequence;
+    private int _loadedSequence;
+    private TResource? _published;
+    private TResource? _current;
+    private int _retiredWriteIndex;
+    private int _retiredReadIndex;
+    private Exception? _lastException;
+
+    internal AudioResourceSlot(AudioResourceLoader loader, Func<TRequest, CancellationToken, TResource?> load, int retiredCapacity, bool allowAudioThreadRequests) : base(loader)
+    {
+        _load = load;
+        _retired = new TResource?[retiredCapacity];
+        AllowAudioThreadRequests = allowAudioThreadRequests;
+    }
+
+    /// <summary>
+    /// Gets a boolean indicating whether <see cref="TryRequestLoad"/> can be called from the audio thread.
+    /// </summary>
+    public bool AllowAudioThreadRequests { get; }
+
+    /// <summary>
+    /// Gets the resource acquired by the last call to <see cref="Acquire"/>. Must only be used from the audio thread.
+    /// </summary>
+    public TResource? Current => _current;
+
+    /// <summary>
+    /// Gets the exception thrown by the last load or dispose that failed, or null.
+    /// </summary>
+    public Exception? LastException => Volatile.Read(ref _lastException);
+
+    /// <summary>
+    /// Requests to load a resource and wakes up the loader thread. The load runs asynchronously on the loader thread and only the latest request is loaded.
+    /// </summary>
+    /// <param name="request">The description of the resource to load.</param>
+    /// <remarks>
+    /// This method must not be called from the audio thread: it can wait for another thread requesting a load and signals the loader thread. Use <see cref="TryRequestLoad"/> instead.
+    /// </remarks>
+    /// <exception cref="ObjectDisposedException">If the loader is disposed.</exception>
+    public void RequestLoad(TRequest request)
+    {
+        ObjectDisposedException.ThrowIf(Loader.IsDisposed, Loader);
+
+        var spinWait = new SpinWait();
+        while (!TryWriteRequest(request))
+        {
+            spinWait.SpinOnce();
+        }
+        Loader.Wake();
+    }
+
+    /// <summary>
+    /// Tries to request to load a resource from the audio thread (e.g. on a program change). The load runs asynchronously on the loader thread and only the latest request is loaded.
+    /// </summary>
+    /// <param name="request">The description of the resource to load.</param>
+    /// <returns><c>true</c> if the request was published; <c>false</c> if another thread is requesting a load at the same time or if the loader is disposed. The request can be retried at the next block.</returns>
+    /// <remarks>
+    /// This method doesn't allocate, doesn't wait and doesn't signal the loader thread: the loader thread picks the request within <see cref="AudioResourceLoader.PollingInterval"/>.
+    /// </remarks>
+    /// <exception cref="InvalidOperationException">If this slot was not created with <c>allowAudioThreadRequests</c>.</exception>
+    public bool TryRequestLoad(TRequest request)
+    {
+        if (!AllowAudioThreadRequests) throw new InvalidOperationException("This slot doesn't accept requests from the audio thread. It must be created with allowAudioThreadRequests: true");
+        return !Loader.IsDisposed && TryWriteRequest(request);
+    }
+
+    /// <summary>
+    /// Acquires the latest published resource. This method must be called from the audio thread at the start of a block (e.g. at the start of <c>ProcessMain</c>).
+    /// </summary>
+    /// <returns>The current resource, or null if no resource has been loaded yet.</returns>
+    /// <remarks>
+    /// The returned resource must not be kept after the end of the block: it can be retired at the next call of this method.
+    /// </remarks>
+    public TResource? Acquire()
+    {
+        if (Volatile.Read(ref _published) is not null)
+        {
+            var current = _current;
+            var writeIndex = _retiredWriteIndex;
+            // Keep the current resource if the loader thread has not reclaimed the previous ones yet
+            if (current is null || writeIndex - Volatile.Read(ref _retiredReadIndex) < _retired.Length)
+            {
+                // Retire before taking the published resource, so that the loader thread keeps polling until it sees the retired resource
+                if (current is not null)
+                {
+                    _retired[(uint)writeIndex % (uint)_retired.Length] = current;
+                    Volatile.Write(ref _retiredWriteIndex, writeIndex + 1);
+                }
+                _current = Interlocked.Exchange(ref _published, null);
+            }
+        }
+
+        return _current;
+    }
+
+    internal override void RunPendingLoad(CancellationToken cancellationToken)
+    {
+        var sequence = ReadRequest(out var request);
+        if (sequence == _loadedSequence) return;
+        _loadedSequence = sequence;
+
+        TResource? resource;
+        try
+        {
+            resource = _load(request!, cancellationToken);
+        }
+        catch (OperationCanceledException) when (cancellationToken.IsCancellationRequested)
+        {
+            return;
+        }
+        catch (Exception ex)
+        {
+            Volatile.Write(ref _lastException, ex);
+            return;
+        }
+
+        if (resource is null) return;
+
+        // Don't publish a resource already superseded by a newer request
+        if (Volatile.Read(ref _requestSequence) != sequence || cancellationToken.IsCancellationRequested)
+        {
+            Release(resource);
+            return;
+        }
+
+        Volatile.Write(ref _lastException, null);
+
+        // A published resource that has not been acquired by the audio thread was never seen by it and can be released directly
+        var previous = Interlocked.Exchange(ref _published, resource);
+        if (previous is not null)
+        {
+            Release(previous);
+        }
+    }
+
+    internal override void CollectRetired()
+    {
+        var readIndex = _retiredReadIndex;
+        var writeIndex = Volatile.Read(ref _retiredWriteIndex);
+        while (readIndex != writeIndex)
+        {
+            ref var slot = ref _retired[(uint)readIndex % (uint)_retired.Length];
+            var resource = slot;
+            slot = null;
+            readIndex++;
+            Volatile.Write(ref _retiredReadIndex, readIndex);
+            Release(resource);
+        }
+    }
+
+    internal override void ReleaseAll()
+    {
+        CollectRetired();
+        Release(Interlocked.Exchange(ref _published, null));
+        Release(_current);
+        _current = null;
+    }
+
+    internal override bool NeedsPolling => AllowAudioThreadRequests || Volatile.Read(ref _published) is not null || _retiredReadIndex != Volatile.Read(ref _retiredWriteIndex);
+
+    private bool TryWriteRequest(TRequest request)
+    {
+        // Only the threads requesting a load take this lock: the loader thread reads the request without it
+        if (Interlocked.CompareExchange(ref _requestWriteLock, 1, 0) != 0) return false;
+
+        // An odd sequence marks a request being written
+        Interlocked.Increment(ref _requestSequence);
+        _request = request;
+        Interlocked.Increment(ref _requestSequence);
+        Volatile.Write(ref _requestWriteLock, 0);
+        return true;
+    }
+
+    private int ReadRequest(out TRequest? request)
+    {
+        var spinWait = new SpinWait();
+        while (true)
+        {
+            var sequence = Volatile.Read(ref _requestSequence);
+            if ((sequence & 1) == 0)
+            {
+                request = _request;
+                Interlocked.MemoryBarrier();
+                // The request is consistent only if no request was written while copying it
+                if (Volatile.Read(ref _requestSequence) == sequence) return sequence;
+            }
+
+            // Only called from the loader thread, which can wait for a request being written
+            spinWait.SpinOnce();
+        }
+    }
+
+    private void Release(TResource? resource)
+    {
+        if (resource is IDisposable disposable)
+        {
+            try
+            {
+                disposable.Dispose();
+            }
+            catch (Exception ex)
+            {
+                // Don't let a failing resource stop the loader thread
+                Volatile.Write(ref _lastException, ex);
+            }
+        }
+    }
+}
@@ -0,0 +1,36 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+namespace NPlug.Voices;
+
+/// <summary>
+/// The stage of the amplitude envelope of a voice.
+/// </summary>
+public enum AudioVoiceEnvelopeStage : byte
+{
+    /// <summary>
+    /// The voice is not playing.
+    /// </summary>
+    Idle,
+
+    /// <summary>
+    /// The envelope is rising to 1.0.
+    /// </summary>
+    Attack,
+
+    /// <summary>
+    /// The envelope is falling to the sustain level.
+    /// </summary>
+    Decay,
+
+    /// <summary>
+    /// The envelope is held at the sustain level until a note off.
+    /// </summary>
+    Sustain,
+
+    /// <summary>
+    /// The envelope is falling to 0.0 after a note off. The voice is released when reaching 0.0.
+    /// </summary>
+    Release,
+}
@@ -0,0 +1,504 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using System;
+using System.Numerics;
+using System.Runtime.CompilerServices;
+
+namespace NPlug.Voices;
+
+/// <summary>
+/// Polyphonic voice allocator driven by note events, storing the state of the voices in a preallocated <see cref="AudioVoiceState"/>.
+/// </summary>
+/// <remarks>
+/// Typical usage from an <see cref="AudioProcessor{TAudioProcessorModel}"/>:
+/// - Create the manager in the constructor of the processor, all the memory is allocated at that time.
+/// - Call <see cref="SetupProcessing"/> from <c>OnSetupProcessing</c>.
+/// - Call <see cref="TryAddEvent"/> from <c>ProcessEvent</c>.
+/// - Call <see cref="Process{TRenderer}"/> from <c>ProcessMain</c>.
+///
+/// Events are applied at their sample offset within the block: <see cref="Process{TRenderer}"/> splits the block into segments
+/// at each event and at least every <see cref="ControlBlockSize"/> samples, where the envelope of the voices is computed.
+/// No memory is allocated after construction.
+/// </remarks>
+public sealed class AudioVoiceManager
+{
+    private readonly ScheduledEvent[] _events;
+    private readonly float[] _envelopeEnd;
+    private int _eventCount;
+    private long _startCounter;
+    private float _sampleRate;
+    private float _attackSeconds;
+    private float _decaySeconds;
+    private float _sustainLevel;
+    private float _releaseSeconds;
+    private float _attackRate;
+    private float _decayRate;
+    private float _releaseRate;
+    private int _controlBlockSize;
+
+    /// <summary>
+    /// Creates a new instance of this voice manager.
+    /// </summary>
+    /// <param name="maxVoices">The maximum number of voices playing at the same time.</param>
+    /// <param name="stealingPolicy">The policy used to steal a voice when all voices are playing.</param>
+    /// <param name="maxEventsPerBlock">The maximum number of events that can be scheduled per block.</param>
+    public AudioVoiceManager(int maxVoices, AudioVoiceStealingPolicy stealingPolicy = AudioVoiceStealingPolicy.Oldest, int maxEventsPerBlock = 1024)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegativeOrZero(maxVoices);
+        ArgumentOutOfRangeException.ThrowIfNegativeOrZero(maxEventsPerBlock);
+        Voices = new AudioVoiceState(maxVoices);
+        StealingPolicy = stealingPolicy;
+        _events = new ScheduledEvent[maxEventsPerBlock];
+        _envelopeEnd = new float[Voices.Capacity];
+        _attackSeconds = 0.005f;
+        _decaySeconds = 0.1f;
+        _sustainLevel = 0.8f;
+        _releaseSeconds = 0.2f;
+        _controlBlockSize = 32;
+        for (int i = 0; i < Voices.Capacity; i++)
+        {
+            Voices.Clear(i);
+        }
+    }
+
+    /// <summary>
+    /// Gets the state of the voices.
+    /// </summary>
+    public AudioVoiceState Voices { get; }
+
+    /// <summary>
+    /// Gets or sets the policy used to steal a voice when all voices are playing.
+    /// </summary>
+    public AudioVoiceStealingPolicy StealingPolicy { get; set; }
+
+    /// <summary>
+    /// Gets or sets the attack time in seconds of the amplitude envelope. Default is 0.005.
+    /// </summary>
+    public float AttackSeconds
+    {
+        get => _attackSeconds;
+        set
+        {
+            _attackSeconds = Math.Max(0.0f, value);
+            UpdateRates();
+        }
+    }
+
+    /// <summary>
+    /// Gets or sets the decay time in seconds (from 1.0 to 0.0) of the amplitude envelope. Default is 0.1.
+    /// </summary>
+    public float DecaySeconds
+    {
+        get => _decaySeconds;
+        set
+        {
+            _decaySeconds = Math.Max(0.0f, value);
+            UpdateRates();
+        }
+    }
+
+    /// <summary>
+    /// Gets or sets the sustain level of the amplitude envelope, range [0.0, 1.0]. Default is 0.8.
+    /// </summary>
+    public float SustainLevel
+    {
+        get => _sustainLevel;
+        set => _sustainLevel = Math.Clamp(value, 0.0f, 1.0f);
+    }
+
+    /// <summary>
+    /// Gets or sets the release time in seconds (from 1.0 to 0.0) of the amplitude envelope. Default is 0.2.
+    /// </summary>
+    public float ReleaseSeconds
+    {
+        get => _releaseSeconds;
+        set
+        {
+            _releaseSeconds = Math.Max(0.0f, value);
+            UpdateRates();
+        }
+    }
+
+    /// <summary>
+    /// Gets or sets the maximum number of samples of a segment, at which rate the envelopes are computed. Default is 32.
+    /// </summary>
+    public int ControlBlockSize
+    {
+        get => _controlBlockSize;
+        set => _controlBlockSize = Math.Max(1, value);
+    }
+
+    /// <summary>
+    /// Gets the number of events scheduled for the current block.
+    /// </summary>
+    public int ScheduledEventCount => _eventCount;
+
+    /// <summary>
+    /// Setups this manager for the specified process setup. This method must be called from <c>OnSetupProcessing</c>.
+    /// </summary>
+    /// <param name="processSetupData">The process setup data.</param>
+    public void SetupProcessing(in AudioProcessSetupData processSetupData)
+    {
+        _sampleRate = (float)processSetupData.SampleRate;
+        UpdateRates();
+        Reset();
+    }
+
+    /// <summary>
+    /// Stops all the voices immediately and clears the scheduled events.
+    /// </summary>
+    public void Reset()
+    {
+        for (int i = 0; i < Voices.ActiveCount; i++)
+        {
+            Voices.Clear(i);
+        }
+        Voices.ActiveCount = 0;
+        _eventCount = 0;
+    }
+
+    /// <summary>
+    /// Moves all the active voices to the release stage.
+    /// </summary>
+    public void AllNotesOff()
+    {
+        for (int i = 0; i < Voices.ActiveCount; i++)
+        {
+            StartStage(i, AudioVoiceEnvelopeStage.Release);
+        }
+    }
+
+    /// <summary>
+    /// Schedules the specified event to be applied at its sample offset during the next call to <see cref="Process{TRenderer}"/>.
+    /// </summary>
+    /// <param name="audioEvent">The event. Only <see cref="AudioEventKind.NoteOn"/>, <see cref="AudioEventKind.NoteOff"/>, <see cref="AudioEventKind.NoteExpressionValue"/> and <see cref="AudioEventKind.PolyPressure"/> are handled.</param>
+    /// <returns><c>true</c> if the event was scheduled; <c>false</c> if the event is not handled or the event queue is full.</returns>
+    public bool TryAddEvent(in AudioEvent audioEvent)
+    {
+        ScheduledEvent scheduledEvent;
+        switch (audioEvent.Kind)
+        {
+            case AudioEventKind.NoteOn:
+                ref readonly var noteOn = ref audioEvent.Value.NoteOn;
+                scheduledEvent = new ScheduledEvent(audioEvent.Kind, audioEvent.SampleOffset, noteOn.NoteId, noteOn.Pitch, noteOn.Channel, noteOn.Velocity, noteOn.Tuning, 0);
+                break;
+            case AudioEventKind.NoteOff:
+                ref readonly var noteOff = ref audioEvent.Value.NoteOff;
+                scheduledEvent = new ScheduledEvent(audioEvent.Kind, audioEvent.SampleOffset, noteOff.NoteId, noteOff.Pitch, noteOff.Channel, noteOff.Velocity, noteOff.Tuning, 0);
+                break;
+            case AudioEventKind.PolyPressure:
+                ref readonly var polyPressure = ref audioEvent.Value.PolyPressure;
+                scheduledEvent = new ScheduledEvent(audioEvent.Kind, audioEvent.SampleOffset, polyPressure.NoteId, polyPressure.Pitch, polyPressure.Channel, polyPressure.Pressure, 0, 0);
+                break;
+            case AudioEventKind.NoteExpressionValue:
+                ref readonly var expression = ref audioEvent.Value.NoteExpressionValue;
+                scheduledEvent = new ScheduledEvent(audioEvent.Kind, audioEvent.SampleOffset, expression.NoteId, 0, 0, (float)expression.Value, 0, expression.TypeId);
+                break;
+            default:
+                return false;
+        }
+
+        if (_eventCount == _events.Length) return false;
+
+        // Keep the events sorted by sample offset, preserving the order of events with the same offset
+        var index = _eventCount;
+        while (index > 0 && _events[index - 1].SampleOffset > scheduledEvent.SampleOffset)
+        {
+            _events[index] = _events[index - 1];
+            index--;
+        }
+        _events[index] = scheduledEvent;
+        _eventCount++;
+        return true;
+    }
+
+    /// <summary>
+    /// Applies the scheduled events at their sample offset and renders the active voices for the specified number of samples.
+    /// </summary>
+    /// <typeparam name="TRenderer">The type of the renderer. Use a struct to allow the render loop to be inlined.</typeparam>
+    /// <param name="sampleCount">The number of samples of the block.</param>
+    /// <param name="renderer">The renderer of the voices.</param>
+    public void Process<TRenderer>(int sampleCount, ref TRenderer renderer) where TRenderer : IAudioVoiceRenderer
+    {
+        var voices = Voices;
+        var eventIndex = 0;
+        var position = 0;
+        while (position < sampleCount)
+        {
+            while (eventIndex < _eventCount && _events[eventIndex].SampleOffset <= position)
+            {
+                ApplyEvent(in _events[eventIndex++], ref renderer);
+            }
+
+            var end = Math.Min(sampleCount, position + _controlBlockSize);
+            if (eventIndex < _eventCount && _events[eventIndex].SampleOffset < end)
+            {
+                end = _events[eventIndex].SampleOffset;
+            }
+
+            var length = end - position;
+            if (voices.ActiveCount > 0)
+            {
+                PrepareEnvelopeSegment(length);
+                for (int voiceStart = 0; voiceStart < voices.ActiveCount; voiceStart += voices.BatchSize)
+                {
+                    renderer.RenderVoices(voices, voiceStart, Math.Min(voices.BatchSize, voices.ActiveCount - voiceStart), position, length);
+                }
+                CommitEnvelopeSegment(ref renderer);
+            }
+
+            position = end;
+        }
+
+        // Events at or after the end of the block are applied after rendering it
+        while (eventIndex < _eventCount)
+        {
+            ApplyEvent(in _events[eventIndex++], ref renderer);
+        }
+        _eventCount = 0;
+    }
+
+    private void ApplyEvent<TRenderer>(in ScheduledEvent scheduledEvent, ref TRenderer renderer) where TRenderer : IAudioVoiceRenderer
+    {
+        var voices = Voices;
+        switch (scheduledEvent.Kind)
+        {
+            case AudioEventKind.NoteOn:
+            {
+                var voiceIndex = AllocateVoice();
+                if (voiceIndex < 0) return;
+
+                voices.NoteId[voiceIndex] = scheduledEvent.NoteId;
+                voices.Pitch[voiceIndex] = scheduledEvent.Pitch;
+                voices.Channel[voiceIndex] = scheduledEvent.Channel;
+                voices.Velocity[voiceIndex] = scheduledEvent.Value;
+                voices.Tuning[voiceIndex] = scheduledEvent.Tuning;
+                voices.Pressure[voiceIndex] = 0.0f;
+                voices.Frequency[voiceIndex] = AudioVoiceState.GetFrequency(scheduledEvent.Pitch, scheduledEvent.Tuning);
+                voices.Phase[voiceIndex] = 0.0f;
+                voices.StartOrder[voiceIndex] = _startCounter++;
+                voices.ResetExpressions(voiceIndex);
+                StartStage(voiceIndex, AudioVoiceEnvelopeStage.Attack);
+                renderer.StartVoice(voices, voiceIndex);
+                break;
+            }
+            case AudioEventKind.NoteOff:
+            {
+                var voiceIndex = FindVoice(scheduledEvent.NoteId, scheduledEvent.Pitch, scheduledEvent.Channel, false);
+                if (voiceIndex >= 0)
+                {
+                    StartStage(voiceIndex, AudioVoiceEnvelopeStage.Release);
+                }
+                break;
+            }
+            case AudioEventKind.PolyPressure:
+            {
+                var voiceIndex = FindVoice(scheduledEvent.NoteId, scheduledEvent.Pitch, scheduledEvent.Channel, true);
+                if (voiceIndex >= 0)
+                {
+                    voices.Pressure[voiceIndex] = scheduledEvent.Value;
+                }
+                break;
+            }
+            case AudioEventKind.NoteExpressionValue:
+            {
+                // Note expressions are only addressed by note id
+                if (scheduledEvent.NoteId == -1) return;
+                for (int i = 0; i < voices.ActiveCount; i++)
+                {
+                    if (voices.NoteId[i] == scheduledEvent.NoteId)
+                    {
+                        voices.TrySetExpressionValue(scheduledEvent.TypeId, i, scheduledEvent.Value);
+                        break;
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    private int AllocateVoice()
+    {
+        var voices = Voices;
+        if (voices.ActiveCount < voices.MaxVoices)
+        {
+            var voiceIndex = voices.ActiveCount++;
+            voices.Clear(voiceIndex);
+            return voiceIndex;
+        }
+
+        if (StealingPolicy == AudioVoiceStealingPolicy.None) return -1;
+
+        // Prefer stealing a voice in release, and keep its current envelope level to avoid a click
+        var stolenIndex = FindVoiceToSteal(true);
+        return stolenIndex >= 0 ? stolenIndex : FindVoiceToSteal(false);
+    }
+
+    private int FindVoiceToSteal(bool releasedOnly)
+    {
+        var voices = Voices;
+        var bestIndex = -1;
+        if (StealingPolicy == AudioVoiceStealingPolicy.Oldest)
+        {
+            // Compare the start order as an integer, a float would lose precision after 2^24 notes
+            for (int i = 0; i < voices.ActiveCount; i++)
+            {
+                if (releasedOnly && voices.EnvelopeStage[i] != AudioVoiceEnvelopeStage.Release) continue;
+                if (bestIndex < 0 || voices.StartOrder[i] < voices.StartOrder[bestIndex])
+                {
+                    bestIndex = i;
+                }
+            }
+            return bestIndex;
+        }
+
+        var bestScore = float.MaxValue;
+        for (int i = 0; i < voices.ActiveCount; i++)
+        {
+            if (releasedOnly && voices.EnvelopeStage[i] != AudioVoiceEnvelopeStage.Release) continue;
+
+            // Lowest score is stolen
+            var score = StealingPolicy switch
+            {
+                AudioVoiceStealingPolicy.Quietest => voices.EnvelopeLevel[i] * voices.Velocity[i],
+                AudioVoiceStealingPolicy.Lowest => (float)voices.Pitch[i],
+                _ => (float)-voices.Pitch[i],
+            };
+
+            if (score < bestScore)
+            {
+                bestScore = score;
+                bestIndex = i;
+            }
+        }
+        return bestIndex;
+    }
+
+    private int FindVoice(int noteId, short pitch, short channel, bool includeReleased)
+    {
+        var voices = Voices;
+        var bestIndex = -1;
+        for (int i = 0; i < voices.ActiveCount; i++)
+        {
+            if (!includeReleased && voices.EnvelopeStage[i] == AudioVoiceEnvelopeStage.Release) continue;
+
+            // Match by note id if available, otherwise by pitch and channel
+            var match = noteId != -1 ? voices.NoteId[i] == noteId : voices.Pitch[i] == pitch && voices.Channel[i] == channel;
+            if (match && (bestIndex < 0 || voices.StartOrder[i] < voices.StartOrder[bestIndex]))
+            {
+                bestIndex = i;
+            }
+        }
+        return bestIndex;
+    }
+
+    private void StartStage(int voiceIndex, AudioVoiceEnvelopeStage stage)
+    {
+        var voices = Voices;
+        voices.EnvelopeStage[voiceIndex] = stage;
+        switch (stage)
+        {
+            case AudioVoiceEnvelopeStage.Attack:
+                voices.EnvelopeRate[voiceIndex] = _attackRate;
+                voices.EnvelopeTarget[voiceIndex] = 1.0f;
+                break;
+            case AudioVoiceEnvelopeStage.Decay:
+                voices.EnvelopeRate[voiceIndex] = _decayRate;
+                voices.EnvelopeTarget[voiceIndex] = _sustainLevel;
+                break;
+            case AudioVoiceEnvelopeStage.Sustain:
+                voices.EnvelopeRate[voiceIndex] = 0.0f;
+                voices.EnvelopeTarget[voiceIndex] = voices.EnvelopeLevel[voiceIndex];
+                break;
+            case AudioVoiceEnvelopeStage.Release:
+                voices.EnvelopeRate[voiceIndex] = _releaseRate;
+                voices.EnvelopeTarget[voiceIndex] = 0.0f;
+                break;
+        }
+    }
+
+    private void PrepareEnvelopeSegment(int length)
+    {
+        var voices = Voices;
+        var levels = voices.EnvelopeLevel;
+        var rates = voices.EnvelopeRate;
+        var targets = voices.EnvelopeTarget;
+        var increments = voices.EnvelopeIncrement;
+        var lengthVector = new Vector<float>(length);
+        var inverseLengthVector = new Vector<float>(1.0f / length);
+
+        // Arrays are padded to a multiple of Vector<float>.Count, so we can always process full vectors
+        for (int i = 0; i < voices.ActiveCount; i += Vector<float>.Count)
+        {
+            var level = new Vector<float>(levels, i);
+            var rate = new Vector<float>(rates, i);
+            var target = new Vector<float>(targets, i);
+            var candidate = level + rate * lengthVector;
+            var end = Vector.ConditionalSelect(Vector.GreaterThanOrEqual(rate, Vector<float>.Zero), Vector.Min(candidate, target), Vector.Max(candidate, target));
+            ((end - level) * inverseLengthVector).CopyTo(increments, i);
+            end.CopyTo(_envelopeEnd, i);
+        }
+    }
+
+    private void CommitEnvelopeSegment<TRenderer>(ref TRenderer renderer) where TRenderer : IAudioVoiceRenderer
+    {
+        var voices = Voices;
+        var i = 0;
+        while (i < voices.ActiveCount)
+        {
+            var level = _envelopeEnd[i];
+            voices.EnvelopeLevel[i] = level;
+            if (level == voices.EnvelopeTarget[i])
+            {
+                switch (voices.EnvelopeStage[i])
+                {
+                    case AudioVoiceEnvelopeStage.Attack:
+                        StartStage(i, AudioVoiceEnvelopeStage.Decay);
+                        break;
+                    case AudioVoiceEnvelopeStage.Decay:
+                        StartStage(i, AudioVoiceEnvelopeStage.Sustain);
+                        break;
+                    case AudioVoiceEnvelopeStage.Release:
+                        RemoveVoice(i, ref renderer);
+                        // The last voice has been moved to this index, check it again
+                        continue;
+                }
+            }
+            i++;
+        }
+    }
+
+    private void RemoveVoice<TRenderer>(int voiceIndex, ref TRenderer renderer) where TRenderer : IAudioVoiceRenderer
+    {
+        var voices = Voices;
+        var lastIndex = voices.ActiveCount - 1;
+        if (voiceIndex != lastIndex)
+        {
+            voices.Move(lastIndex, voiceIndex);
+            _envelopeEnd[voiceIndex] = _envelopeEnd[lastIndex];
+            renderer.MoveVoice(voices, lastIndex, voiceIndex);
+        }
+        voices.Clear(lastIndex);
+        voices.ActiveCount = lastIndex;
+    }
+
+    private void UpdateRates()
+    {
+        if (_sampleRate <= 0) return;
+        _attackRate = GetRate(_attackSeconds);
+        _decayRate = -GetRate(_decaySeconds);
+        _releaseRate = -GetRate(_releaseSeconds);
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private float GetRate(float seconds)
+    {
+        // A zero time reaches the target in a single sample
+        var samples = seconds * _sampleRate;
+        return samples < 1.0f ? 1.0f : 1.0f / samples;
+    }
+
+    private readonly record struct ScheduledEvent(AudioEventKind Kind, int SampleOffset, int NoteId, short Pitch, short Channel, float Value, float Tuning, uint TypeId);
+}
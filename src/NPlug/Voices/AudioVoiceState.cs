@@ -0,0 +1,204 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+using System;
+using System.Numerics;
+using System.Runtime.CompilerServices;
+
+namespace NPlug.Voices;
+
+/// <summary>
+/// Structure-of-arrays state of the voices managed by a <see cref="AudioVoiceManager"/>.
+/// </summary>
+/// <remarks>
+/// Active voices are always stored contiguously in the range [0, <see cref="ActiveCount"/>), so that a render loop can process them in batches of <see cref="BatchSize"/> voices.
+/// All arrays are preallocated with a length of <see cref="Capacity"/>.
+/// </remarks>
+public sealed class AudioVoiceState
+{
+    /// <summary>
+    /// The number of predefined note expressions stored per voice (from <see cref="AudioNoteExpressionTypeId.Volume"/> to <see cref="AudioNoteExpressionTypeId.Brightness"/>).
+    /// </summary>
+    public const int ExpressionTypeCount = (int)AudioNoteExpressionTypeId.Brightness + 1;
+
+    private readonly float[] _expressions;
+    private readonly float[] _expressionDefaults;
+
+    internal AudioVoiceState(int maxVoices)
+    {
+        MaxVoices = maxVoices;
+        BatchSize = Vector<float>.Count;
+        Capacity = (maxVoices + BatchSize - 1) / BatchSize * BatchSize;
+        NoteId = new int[Capacity];
+        Pitch = new short[Capacity];
+        Channel = new short[Capacity];
+        Velocity = new float[Capacity];
+        Tuning = new float[Capacity];
+        Pressure = new float[Capacity];
+        Frequency = new float[Capacity];
+        Phase = new float[Capacity];
+        EnvelopeStage = new AudioVoiceEnvelopeStage[Capacity];
+        EnvelopeLevel = new float[Capacity];
+        EnvelopeIncrement = new float[Capacity];
+        EnvelopeRate = new float[Capacity];
+        EnvelopeTarget = new float[Capacity];
+        StartOrder = new long[Capacity];
+        _expressions = new float[ExpressionTypeCount * Capacity];
+        // Normalized default values as defined by the VST3 SDK
+        _expressionDefaults = new float[ExpressionTypeCount];
+        _expressionDefaults[(int)AudioNoteExpressionTypeId.Volume] = 0.25f;
+        _expressionDefaults[(int)AudioNoteExpressionTypeId.Pan] = 0.5f;
+        _expressionDefaults[(int)AudioNoteExpressionTypeId.Tuning] = 0.5f;
+        _expressionDefaults[(int)AudioNoteExpressionTypeId.Brightness] = 0.5f;
+    }
+
+    /// <summary>
+    /// Gets the maximum number of voices playing at the same time.
+    /// </summary>
+    public int MaxVoices { get; }
+
+    /// <summary>
+    /// Gets the number of voices processed per batch (the number of float lanes of <see cref="Vector{T}"/>).
+    /// </summary>
+    public int BatchSize { get; }
+
+    /// <summary>
+    /// Gets the length of the arrays, <see cref="MaxVoices"/> aligned up to <see cref="BatchSize"/>.
+    /// </summary>
+    public int Capacity { get; }
+
+    /// <summary>
+    /// Gets the number of active voices.
+    /// </summary>
+    public int ActiveCount { get; internal set; }
+
+    /// <summary>
+    /// Gets the note id of each voice.
+    /// </summary>
+    public int[] NoteId { get; }
+
+    /// <summary>
+    /// Gets the pitch of each voice, range [0, 127].
+    /// </summary>
+    public short[] Pitch { get; }
+
+    /// <summary>
+    /// Gets the channel in the event bus of each voice.
+    /// </summary>
+    public short[] Channel { get; }
+
+    /// <summary>
+    /// Gets the velocity of each voice, range [0.0, 1.0].
+    /// </summary>
+    public float[] Velocity { get; }
+
+    /// <summary>
+    /// Gets the tuning of each voice in cents, as received by the note on.
+    /// </summary>
+    public float[] Tuning { get; }
+
+    /// <summary>
+    /// Gets the last poly pressure received for each voice, range [0.0, 1.0].
+    /// </summary>
+    public float[] Pressure { get; }
+
+    /// <summary>
+    /// Gets the frequency in Hz of each voice computed from its pitch and tuning.
+    /// </summary>
+    public float[] Frequency { get; }
+
+    /// <summary>
+    /// Gets the phase of each voice. This array is reset to 0 when a voice is started and is free to be used by the renderer.
+    /// </summary>
+    public float[] Phase { get; }
+
+    /// <summary>
+    /// Gets the envelope stage of each voice.
+    /// </summary>
+    public AudioVoiceEnvelopeStage[] EnvelopeStage { get; }
+
+    /// <summary>
+    /// Gets the envelope level of each voice at the start of the current segment.
+    /// </summary>
+    public float[] EnvelopeLevel { get; }
+
+    /// <summary>
+    /// Gets the per-sample envelope increment of each voice for the current segment.
+    /// </summary>
+    public float[] EnvelopeIncrement { get; }
+
+    internal float[] EnvelopeRate { get; }
+
+    internal float[] EnvelopeTarget { get; }
+
+    internal long[] StartOrder { get; }
+
+    /// <summary>
+    /// Gets the normalized values of the specified note expression for all the voices.
+    /// </summary>
+    /// <param name="typeId">A predefined note expression type, up to <see cref="AudioNoteExpressionTypeId.Brightness"/>.</param>
+    public Span<float> GetExpressionValues(AudioNoteExpressionTypeId typeId)
+    {
+        if ((uint)typeId >= ExpressionTypeCount) throw new ArgumentOutOfRangeException(nameof(typeId));
+        return _expressions.AsSpan((int)typeId * Capacity, Capacity);
+    }
+
+    /// <summary>
+    /// Gets the frequency in Hz of the specified pitch and tuning (12-TET, pitch 69 = 440Hz).
+    /// </summary>
+    /// <param name="pitch">The pitch, range [0, 127].</param>
+    /// <param name="tuningInCents">The tuning in cents.</param>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public static float GetFrequency(int pitch, float tuningInCents)
+    {
+        return 440.0f * MathF.Pow(2.0f, (pitch - 69 + tuningInCents * 0.01f) * (1.0f / 12.0f));
+    }
+
+    internal bool TrySetExpressionValue(uint typeId, int voiceIndex, float value)
+    {
+        if (typeId >= ExpressionTypeCount) return false;
+        _expressions[(int)typeId * Capacity + voiceIndex] = value;
+        return true;
+    }
+
+    internal void ResetExpressions(int voiceIndex)
+    {
+        for (int i = 0; i < ExpressionTypeCount; i++)
+        {
+            _expressions[i * Capacity + voiceIndex] = _expressionDefaults[i];
+        }
+    }
+
+    internal void Move(int fromIndex, int toIndex)
+    {
+        NoteId[toIndex] = NoteId[fromIndex];
+        Pitch[toIndex] = Pitch[fromIndex];
+        Channel[toIndex] = Channel[fromIndex];
+        Velocity[toIndex] = Velocity[fromIndex];
+        Tuning[toIndex] = Tuning[fromIndex];
+        Pressure[toIndex] = Pressure[fromIndex];
+        Frequency[toIndex] = Frequency[fromIndex];
+        Phase[toIndex] = Phase[fromIndex];
+        EnvelopeStage[toIndex] = EnvelopeStage[fromIndex];
+        EnvelopeLevel[toIndex] = EnvelopeLevel[fromIndex];
+        EnvelopeIncrement[toIndex] = EnvelopeIncrement[fromIndex];
+        EnvelopeRate[toIndex] = EnvelopeRate[fromIndex];
+        EnvelopeTarget[toIndex] = EnvelopeTarget[fromIndex];
+        StartOrder[toIndex] = StartOrder[fromIndex];
+        for (int i = 0; i < ExpressionTypeCount; i++)
+        {
+            _expressions[i * Capacity + toIndex] = _expressions[i * Capacity + fromIndex];
+        }
+    }
+
+    internal void Clear(int voiceIndex)
+    {
+        NoteId[voiceIndex] = -1;
+        EnvelopeStage[voiceIndex] = AudioVoiceEnvelopeStage.Idle;
+        EnvelopeLevel[voiceIndex] = 0.0f;
+        EnvelopeIncrement[voiceIndex] = 0.0f;
+        EnvelopeRate[voiceIndex] = 0.0f;
+        EnvelopeTarget[voiceIndex] = 0.0f;
+    }
+}
@@ -0,0 +1,39 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+namespace NPlug.Voices;
+
+/// <summary>
+/// Defines which voice is stolen by <see cref="AudioVoiceManager"/> when a note on is received while all voices are playing.
+/// </summary>
+/// <remarks>
+/// For all policies except <see cref="None"/>, voices in the <see cref="AudioVoiceEnvelopeStage.Release"/> stage are stolen first.
+/// </remarks>
+public enum AudioVoiceStealingPolicy
+{
+    /// <summary>
+    /// No voice is stolen, the new note is ignored.
+    /// </summary>
+    None,
+
+    /// <summary>
+    /// The voice started the earliest is stolen.
+    /// </summary>
+    Oldest,
+
+    /// <summary>
+    /// The voice with the lowest envelope level multiplied by its velocity is stolen.
+    /// </summary>
+    Quietest,
+
+    /// <summary>
+    /// The voice with the lowest pitch is stolen.
+    /// </summary>
+    Lowest,
+
+    /// <summary>
+    /// The voice with the highest pitch is stolen.
+    /// </summary>
+    Highest,
+}
@@ -0,0 +1,42 @@
+// Copyright (c) Alexandre Mutel. All rights reserved.
+// Licensed under the BSD-Clause 2 license.
+// See license.txt file in the project root for full license information.
+
+namespace NPlug.Voices;
+
+/// <summary>
+/// Callbacks used by <see cref="AudioVoiceManager.Process{TRenderer}"/> to render the active voices.
+/// </summary>
+/// <remarks>
+/// Implement this interface on a struct to allow the render loop to be inlined.
+/// </remarks>
+public interface IAudioVoiceRenderer
+{
+    /// <summary>
+    /// Called when a voice is started by a note on (including a stolen voice). Use it to reset any per-voice state owned by the renderer.
+    /// </summary>
+    /// <param name="voices">The voice state.</param>
+    /// <param name="voiceIndex">The index of the started voice.</param>
+    void StartVoice(AudioVoiceState voices, int voiceIndex);
+
+    /// <summary>
+    /// Called when an active voice is moved to another index to keep the active voices contiguous. Use it to move any per-voice state owned by the renderer.
+    /// </summary>
+    /// <param name="voices">The voice state.</param>
+    /// <param name="fromIndex">The previous index of the voice.</param>
+    /// <param name="toIndex">The new index of the voice.</param>
+    void MoveVoice(AudioVoiceState voices, int fromIndex, int toIndex);
+
+    /// <summary>
+    /// Renders a batch of active voices for a segment of the current block.
+    /// </summary>
+    /// <param name="voices">The voice state.</param>
+    /// <param name="voiceStart">The index of the first voice of the batch.</param>
+    /// <param name="voiceCount">The number of voices in the batch. Arrays of <paramref name="voices"/> are padded so that a full batch of <see cref="AudioVoiceState.BatchSize"/> voices can always be loaded.</param>
+    /// <param name="sampleOffset">The offset of the segment in the block.</param>
+    /// <param name="sampleCount">The number of samples in the segment.</param>
+    /// <remarks>
+    /// The envelope gain of a voice <c>v</c> at the sample <c>i</c> of the segment is <c>EnvelopeLevel[v] + EnvelopeIncrement[v] * i</c>.
+    /// </remarks>
+    void RenderVoices(AudioVoiceState voices, int voiceStart, int voiceCount, int sampleOffset, int sampleCount);
+}